@@ -19,6 +19,7 @@
  */
 
 #include <cstdio>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
 #include "RPIPCMessage.h"
@@ -379,6 +380,10 @@ int RPSIDPlay::setSIDEmulator(RPSIDEmulator sidEmulator)
 
         case RPSIDEmulatorReSIDFP:
             {
+                // Share the lookup tables with the other players, if a cache directory is given.
+                // The players use the files in place: remove stale ones, never truncate them.
+                ReSIDfpBuilder::tableCache(getenv("RPSIDPLAY_TABLE_CACHE"));
+
                 // Set up a SID builder
                 ReSIDfpBuilder *sidEmulationBuilder = new ReSIDfpBuilder("RPSIDPlay");
 
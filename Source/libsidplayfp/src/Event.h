@@ -43,6 +43,9 @@ private:
     /// The next event in sequence.
     Event *next;
 
+    /// The link pointing to this event, nullptr when not scheduled.
+    Event **prev;
+
     /// The clock this event fires.
     event_clock_t triggerTime;
 
@@ -57,6 +60,7 @@ public:
      * @param name Descriptive string of the event.
      */
     Event(const char * const name) :
+        prev(nullptr),
         m_name(name) {}
 
     /**
@@ -28,37 +28,9 @@ namespace libsidplayfp
 
 void EventScheduler::reset()
 {
-    firstEvent = nullptr;
+    while (firstEvent != nullptr)
+        unlink(*firstEvent);
     currentTime = 0;
 }
 
-void EventScheduler::cancel(Event &event)
-{
-    Event **scan = &firstEvent;
-
-    while (*scan != nullptr)
-    {
-        if (&event == *scan)
-        {
-            *scan = (*scan)->next;
-            break;
-        }
-        scan = &((*scan)->next);
-    }
-}
-
-bool EventScheduler::isPending(Event &event) const
-{
-    Event *scan = firstEvent;
-    while (scan != nullptr)
-    {
-        if (&event == scan)
-        {
-            return true;
-        }
-        scan = scan->next;
-    }
-    return false;
-}
-
 }
@@ -48,6 +48,8 @@ typedef enum
  * Fast EventScheduler, which maintains a linked list of Events.
  * This scheduler takes neglible time even when it is used to
  * schedule events for nearly every clock.
+ * Each event knows the link pointing to it, so cancelling
+ * and checking for a pending event take constant time.
  *
  * Events occur on an internal clock which is 2x the visible clock.
  * The visible clock is divided to two phases called phi1 and phi2.
@@ -75,20 +77,51 @@ private:
      */
     void schedule(Event &event)
     {
+        // an event can be queued only once
+        if (event.prev != nullptr)
+            unlink(event);
+
         // find the right spot where to tuck this new event
         Event **scan = &firstEvent;
         for (;;)
         {
             if ((*scan == nullptr) || ((*scan)->triggerTime > event.triggerTime))
             {
-                 event.next = *scan;
-                 *scan = &event;
+                 link(event, scan);
                  break;
              }
              scan = &((*scan)->next);
          }
     }
 
+    /**
+     * Insert an event in the queue.
+     *
+     * @param event the event to insert
+     * @param pos the link that will point to the event
+     */
+    static void link(Event &event, Event **pos)
+    {
+        event.next = *pos;
+        event.prev = pos;
+        if (*pos != nullptr)
+            (*pos)->prev = &event.next;
+        *pos = &event;
+    }
+
+    /**
+     * Remove an event from the queue.
+     *
+     * @param event the event to remove
+     */
+    static void unlink(Event &event)
+    {
+        *event.prev = event.next;
+        if (event.next != nullptr)
+            event.next->prev = event.prev;
+        event.prev = nullptr;
+    }
+
 public:
     EventScheduler() :
         firstEvent(nullptr),
@@ -127,7 +160,11 @@ public:
      *
      * @param event the event to cancel
      */
-    void cancel(Event &event);
+    void cancel(Event &event)
+    {
+        if (event.prev != nullptr)
+            unlink(event);
+    }
 
     /**
      * Cancel all pending events and reset time.
@@ -140,7 +177,7 @@ public:
     void clock()
     {
         Event &event = *firstEvent;
-        firstEvent = firstEvent->next;
+        unlink(event);
         currentTime = event.triggerTime;
         event.event();
     }
@@ -151,7 +188,7 @@ public:
      * @param event the event
      * @return true when pending
      */
-    bool isPending(Event &event) const;
+    bool isPending(Event &event) const { return event.prev != nullptr; }
 
     /**
      * Get time with respect to a specific clock phase.
@@ -172,6 +209,17 @@ public:
     event_phase_t phase() const { return static_cast<event_phase_t>(currentTime & 1); }
 
     event_clock_t remaining(Event &event) const { return event.triggerTime - currentTime; }
+
+    /**
+     * Get the time until the next pending event fires.
+     *
+     * @return the number of half-cycles to the next event,
+     *         0 if no event is pending
+     */
+    event_clock_t nextEventDelay() const
+    {
+        return (firstEvent != nullptr) ? firstEvent->triggerTime - currentTime : 0;
+    }
 };
 
 }
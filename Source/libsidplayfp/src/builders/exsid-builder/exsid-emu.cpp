@@ -179,7 +179,8 @@ void exSID::unlock()
 }
 
 void exSID::sampling(float systemclock, float freq,
-        SidConfig::sampling_method_t method, bool)
+        SidConfig::sampling_method_t method, bool,
+        SidConfig::sampling_quality_t)
 {
     exSID_audio_op(exsid, XS_AU_MUTE);
     if (systemclock < 1000000.0F)
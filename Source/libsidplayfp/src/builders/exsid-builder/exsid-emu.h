@@ -80,7 +80,8 @@ public:
     void filter(bool) {}
 
     void sampling(float systemclock, float freq,
-        SidConfig::sampling_method_t method, bool) override;
+        SidConfig::sampling_method_t method, bool,
+        SidConfig::sampling_quality_t) override;
 
     // exSID specific
     void flush();
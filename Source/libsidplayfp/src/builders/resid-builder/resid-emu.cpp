@@ -95,6 +95,15 @@ void ReSID::clock()
 {
     reSID::cycle_count cycles = eventScheduler->getTime(EVENT_CLOCK_PHI1) - m_accessClk;
     m_accessClk += cycles;
+
+    if (m_outputPos < m_outputSize)
+    {
+        // The chip stops at the end of the block, leaving the cycles not yet clocked
+        m_outputPos += m_sid.clock(cycles, m_output + m_outputPos * m_outputStride, m_outputSize - m_outputPos, m_outputStride);
+        if (cycles == 0)
+            return;
+    }
+
     m_bufferpos += m_sid.clock(cycles, (short *) m_buffer + m_bufferpos, OUTPUTBUFFERSIZE - m_bufferpos, 1);
 }
 
@@ -104,7 +113,8 @@ void ReSID::filter(bool enable)
 }
 
 void ReSID::sampling(float systemclock, float freq,
-        SidConfig::sampling_method_t method, bool fast)
+        SidConfig::sampling_method_t method, bool fast,
+        SidConfig::sampling_quality_t)
 {
     reSID::sampling_method sampleMethod;
     switch (method)
@@ -64,8 +64,11 @@ public:
     // Standard SID emu functions
     void clock() override;
 
+    bool directOutput() const override { return true; }
+
     void sampling(float systemclock, float freq,
-        SidConfig::sampling_method_t method, bool fast) override;
+        SidConfig::sampling_method_t method, bool fast,
+        SidConfig::sampling_quality_t) override;
 
     void voice(unsigned int num, bool mute) override;
 
@@ -0,0 +1,41 @@
+//  ---------------------------------------------------------------------------
+//  This file is part of reSID, a MOS6581 SID emulator engine.
+//  Copyright (C) 2010  Dag Lem <resid@nimrod.no>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//  ---------------------------------------------------------------------------
+
+#ifndef RESID_DOT_H
+#define RESID_DOT_H
+
+// The FIR convolutions use the SIMD dot product of reSIDfp, which picks
+// the fastest kernel for the running CPU; both engines are linked into
+// the same library.
+#include "../../residfp-builder/residfp/resample/dotProduct.h"
+
+namespace reSID
+{
+
+// ----------------------------------------------------------------------------
+// Sum of the products of samples and FIR coefficients, not scaled.
+// ----------------------------------------------------------------------------
+inline int dot_product(const short* sample, const short* fir, int n)
+{
+  return reSIDfp::dotProduct(sample, fir, n);
+}
+
+} // namespace reSID
+
+#endif
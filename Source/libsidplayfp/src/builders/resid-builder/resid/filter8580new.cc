@@ -27,8 +27,14 @@
 #include "filter8580new.h"
 #include "dac.h"
 #include "spline.h"
+#include "../../residfp-builder/residfp/TableCache.h"
+#include "../../residfp-builder/residfp/TableImage.h"
+#include <limits.h>
 #include <math.h>
 
+using reSIDfp::TableCache;
+using reSIDfp::TableImage;
+
 namespace reSID
 {
 
@@ -243,6 +249,33 @@ static double log1p(double x)
 #endif
 
 Filter::model_filter_t Filter::model_filter[2];
+bool Filter::model_init[2];
+
+// Entries of each op-amp table checked against the solver before the baked
+// tables are used. The solver works on integers only, so the tables follow
+// from the fingerprinted op-amp table; this just guards against a changed
+// solver.
+static const int CHECK_ENTRIES = 64;
+
+// Store a solved table entry, or just compare it when checking.
+static inline bool store(unsigned short& entry, int value, bool check)
+{
+  if (check) {
+    return entry == value;
+  }
+  entry = value;
+  return true;
+}
+
+
+// The op-amp tables in the form of the image codec.
+static void image_tables(std::vector<TableImage::table_t>& tables, unsigned short* data[], unsigned int size[], int n)
+{
+  for (int t = 0; t < n; t++) {
+    TableImage::table_t table = { data[t], size[t] };
+    tables.push_back(table);
+  }
+}
 
 
 // ----------------------------------------------------------------------------
@@ -253,17 +286,17 @@ Filter::Filter()
   static bool class_init;
 
   if (!class_init) {
+    // Only the model parameters are calculated here, the lookup tables of
+    // a chip model are built by init_model() when the model is first used.
     double tmp_n_param[2];
 
-    // Temporary tables for op-amp transfer function.
-    unsigned int* voltages = new unsigned int[1 << 16];
+    // Temporary table for op-amp transfer function.
     opamp_t* opamp = new opamp_t[1 << 16];
 
     for (int m = 0; m < 2; m++) {
       model_filter_init_t& fi = model_filter_init[m];
       model_filter_t& mf = model_filter[m];
 
-      // Convert op-amp voltage transfer to 16 bit values.
       double vmin = fi.opamp_voltage[0][0];
       double opamp_max = fi.opamp_voltage[0][1];
       double kVddt = fi.k*(fi.Vdd - fi.Vth);
@@ -274,7 +307,6 @@ Filter::Filter()
       // Scaling and translation constants.
       double N16 = norm*((1u << 16) - 1);
       double N30 = norm*((1u << 30) - 1);
-      double N31 = norm*((1u << 31) - 1);
       mf.vo_N16 = N16;
 
       // The "zero" output level of the voices.
@@ -290,164 +322,28 @@ Filter::Filter()
 
       tmp_n_param[m] = denorm*(1 << 13)*((fi.uCox/2.)*1.0e-6/fi.C);
 
-      // Create lookup table mapping op-amp voltage across output and input
-      // to input voltage: vo - vx -> vx
-      // FIXME: No variable length arrays in ISO C++, hardcoding to max 50
-      // points.
-      // double_point scaled_voltage[fi.opamp_voltage_size];
-      double_point scaled_voltage[50];
-
-      for (int i = 0; i < fi.opamp_voltage_size; i++) {
-        // The target output range is 16 bits, in order to fit in an unsigned
-        // short.
-        //
-        // The y axis is temporarily scaled to 31 bits for maximum accuracy in
-        // the calculated derivative.
-        //
-        // Values are normalized using
-        //
-        //   x_n = m*2^N*(x - xmin)
-        //
-        // and are translated back later (for fixed point math) using
-        //
-        //   m*2^N*x = x_n - m*2^N*xmin
-        //
-        scaled_voltage[fi.opamp_voltage_size - 1 - i][0] = int(N16*(fi.opamp_voltage[i][1] - fi.opamp_voltage[i][0] + denorm)/2 + 0.5);
-        scaled_voltage[fi.opamp_voltage_size - 1 - i][1] = N31*(fi.opamp_voltage[i][0] - vmin);
-      }
-
-      // Clamp x to 16 bits (rounding may cause overflow).
-      if (scaled_voltage[fi.opamp_voltage_size - 1][0] >= (1 << 16)) {
-        // The last point is repeated.
-        scaled_voltage[fi.opamp_voltage_size - 1][0] =
-            scaled_voltage[fi.opamp_voltage_size - 2][0] = (1 << 16) - 1;
-      }
-
-      interpolate(scaled_voltage, scaled_voltage + fi.opamp_voltage_size - 1,
-                    PointPlotter<unsigned int>(voltages), 1.0);
-
-      // Store both fn and dfn in the same table.
-      mf.ak = (int)scaled_voltage[0][0];
-      mf.bk = (int)scaled_voltage[fi.opamp_voltage_size - 1][0];
-      int j;
-      for (j = 0; j < mf.ak; j++) {
-        opamp[j].vx = 0;
-        opamp[j].dvx = 0;
-      }
-      unsigned int f = voltages[j];
-      for (; j <= mf.bk; j++) {
-        unsigned int fp = f;
-        f = voltages[j];  // Scaled by m*2^31
-        // m*2^31*dy/1 = (m*2^31*dy)/(m*2^16*dx) = 2^15*dy/dx
-        int df = f - fp;  // Scaled by 2^15
-
-        // 16 bits unsigned: m*2^16*(fn - xmin)
-        opamp[j].vx = f > (0xffff << 15) ? 0xffff : f >> 15;
-        // 16 bits (15 bits + sign bit): 2^11*dfn
-        opamp[j].dvx = df >> (15 - 11);
-      }
-      for (; j < (1 << 16); j++) {
-        opamp[j].vx = 0;
-        opamp[j].dvx = 0;
-      }
-
-      // We don't have the differential for the first point so just assume
-      // it's the same as the second point's
-      opamp[mf.ak].dvx = opamp[mf.ak+1].dvx;
-
-      // Create lookup tables for gains / summers.
-
-      // 4 bit "resistor" ladders in the bandpass resonance gain and the audio
-      // output gain necessitate 16 gain tables.
-      // From die photographs of the bandpass and volume "resistor" ladders
-      // it follows that gain ~ vol/8 and 1/Q ~ ~res/8 (assuming ideal
-      // op-amps and ideal "resistors").
-      for (int n8 = 0; n8 < 16; n8++) {
-        int n = n8 << 4;  // Scaled by 2^7
-        int x = mf.ak;
-        for (int vi = 0; vi < (1 << 16); vi++) {
-          mf.gain[n8][vi] = solve_gain(opamp, n, vi, x, mf);
-        }
-      }
-
-      // The filter summer operates at n ~ 1, and has 5 fundamentally different
-      // input configurations (2 - 6 input "resistors").
-      //
-      // Note that all "on" transistors are modeled as one. This is not
-      // entirely accurate, since the input for each transistor is different,
-      // and transistors are not linear components. However modeling all
-      // transistors separately would be extremely costly.
-      int offset = 0;
-      int size;
-      for (int k = 0; k < 5; k++) {
-        int idiv = 2 + k;        // 2 - 6 input "resistors".
-        int n_idiv = idiv << 7;  // n*idiv, scaled by 2^7
-        size = idiv << 16;
-        int x = mf.ak;
-        for (int vi = 0; vi < size; vi++) {
-          mf.summer[offset + vi] =
-            solve_gain(opamp, n_idiv, vi/idiv, x, mf);
-        }
-        offset += size;
-      }
-
-      // The audio mixer operates at n ~ 8/6, and has 8 fundamentally different
-      // input configurations (0 - 7 input "resistors").
-      //
-      // All "on", transistors are modeled as one - see comments above for
-      // the filter summer.
-      offset = 0;
-      size = 1;  // Only one lookup element for 0 input "resistors".
-      for (int l = 0; l < 8; l++) {
-        int idiv = l;                 // 0 - 7 input "resistors".
-        int n_idiv = (idiv << 7)*8/6; // n*idiv, scaled by 2^7
-        if (idiv == 0) {
-          // Avoid division by zero; the result will be correct since
-          // n_idiv = 0.
-          idiv = 1;
-        }
-        int x = mf.ak;
-        for (int vi = 0; vi < size; vi++) {
-          mf.mixer[offset + vi] =
-            solve_gain(opamp, n_idiv, vi/idiv, x, mf);
-        }
-        offset += size;
-        size = (l + 1) << 16;
-      }
-
-      // Create lookup table mapping capacitor voltage to op-amp input voltage:
-      // vc -> vx
-      for (int m = 0; m < (1 << 16); m++) {
-        mf.opamp_rev[m] = opamp[m].vx;
-      }
-
       mf.vc_max = (int)(N30*(fi.opamp_voltage[0][1] - fi.opamp_voltage[0][0]));
       mf.vc_min = (int)(N30*(fi.opamp_voltage[fi.opamp_voltage_size - 1][1] - fi.opamp_voltage[fi.opamp_voltage_size - 1][0]));
+
+      // The mixer output with no inputs is the "zero" level of EXT IN,
+      // which is needed before the tables are built.
+      opamp_table(m, opamp);
+      int x = mf.ak;
+      mf.mixer[0] = solve_gain(opamp, 0, 0, x, mf);
     }
 
     // Free temporary table.
-    delete[] voltages;
+    delete[] opamp;
 
     unsigned int dac_bits = 11;
 
     {
       // 8580 only
-      for (int n8 = 0; n8 < 16; n8++) {
-        int x = model_filter[1].ak;
-        for (int vi = 0; vi < (1 << 16); vi++) {
-          resonance[n8][vi] = solve_gain(opamp, resGain[n8], vi, x, model_filter[1]);
-        }
-      }
-
       // scaled 5 bits
       n_param = (int)(tmp_n_param[1] * 32 + 0.5);
 
-      model_filter_init_t& fi = model_filter_init[1];
       model_filter_t& f = model_filter[1];
 
-      double Vgt = (4.75 * 1.6) - fi.Vth;
-      nVgt = (int)(f.vo_N16 * (Vgt - fi.opamp_voltage[0][0]) + 0.5);
-
       // DAC table.
       // W/L ratio for frequency DAC, bits are proportional.
       // scaled 5 bits
@@ -466,9 +362,6 @@ Filter::Filter()
       }
     }
 
-    // Free temporary table.
-    delete[] opamp;
-
     {
       // 6581 only
       model_filter_init_t& fi = model_filter_init[0];
@@ -476,8 +369,6 @@ Filter::Filter()
       double N16 = f.vo_N16;
       double vmin = fi.opamp_voltage[0][0];
 
-      Vw_bias = 0;
-
       // Normalized snake current factor, 1 cycle at 1MHz.
       // Fit in 5 bits.
       n_snake = (int)(fi.WL_snake * tmp_n_param[0] + 0.5);
@@ -487,58 +378,362 @@ Filter::Filter()
       for (int n = 0; n < (1 << dac_bits); n++) {
         f.f0_dac[n] = (unsigned short)(N16*(fi.dac_zero + f.f0_dac[n]*fi.dac_scale/(1 << dac_bits) - vmin) + 0.5);
       }
-
-      // VCR table.
-      double k = fi.k;
-      double kVddt = N16*(k*(fi.Vdd - fi.Vth));
-      vmin *= N16;
-
-      for (int i = 0; i < (1 << 16); i++) {
-        // The table index is right-shifted 16 times in order to fit in
-        // 16 bits; the argument to sqrt is thus multiplied by (1 << 16).
-        //
-        // The returned value must be corrected for translation. Vg always
-        // takes part in a subtraction as follows:
-        //
-        //   k*Vg - Vx = (k*Vg - t) - (Vx - t)
-        //
-        // I.e. k*Vg - t must be returned.
-        double Vg = kVddt - sqrt((double)i*(1 << 16));
-        vcr_kVg[i] = (unsigned short)(k*Vg - vmin + 0.5);
-      }
-
-      /*
-        EKV model:
-
-        Ids = Is*(if - ir)
-        Is = ((2*u*Cox*Ut^2)/k)*W/L
-        if = ln^2(1 + e^((k*(Vg - Vt) - Vs)/(2*Ut))
-        ir = ln^2(1 + e^((k*(Vg - Vt) - Vd)/(2*Ut))
-      */
-      double kVt = fi.k*fi.Vth;
-      double Ut = fi.Ut;
-      double Is = ((2*fi.uCox*Ut*Ut)/fi.k)*fi.WL_vcr;
-      // Normalized current factor for 1 cycle at 1MHz.
-      double N15 = N16/2;
-      double n_Is = N15*1.0e-6/fi.C*Is;
-
-      // kVg_Vx = k*Vg - Vx
-      // I.e. if k != 1.0, Vg must be scaled accordingly.
-      for (int kVg_Vx = 0; kVg_Vx < (1 << 16); kVg_Vx++) {
-        double log_term = log1p(exp((kVg_Vx/N16 - kVt)/(2*Ut)));
-        // Scaled by m*2^15
-        vcr_n_Ids_term[kVg_Vx] = (unsigned short)(n_Is*log_term*log_term);
-      }
     }
 
     class_init = true;
   }
 
   enable_filter(true);
-  set_chip_model(MOS6581);
+  // The tables of the default model are built on first use, so that they
+  // are not built for nothing when another model is selected.
+  sid_model = MOS6581;
   set_voice_mask(0x07);
   input(0);
   reset();
+
+  // The bias is per instance, set it up for each filter.
+  adjust_filter_bias(0);
+}
+
+
+// ----------------------------------------------------------------------------
+// Op-amp transfer function of a chip model.
+// ----------------------------------------------------------------------------
+void Filter::opamp_table(int m, opamp_t* opamp)
+{
+  model_filter_init_t& fi = model_filter_init[m];
+  model_filter_t& mf = model_filter[m];
+
+  // Convert op-amp voltage transfer to 16 bit values.
+  double vmin = fi.opamp_voltage[0][0];
+  double opamp_max = fi.opamp_voltage[0][1];
+  double kVddt = fi.k*(fi.Vdd - fi.Vth);
+  double vmax = kVddt < opamp_max ? opamp_max : kVddt;
+  double denorm = vmax - vmin;
+  double norm = 1.0/denorm;
+
+  // Scaling and translation constants.
+  double N16 = norm*((1u << 16) - 1);
+  double N31 = norm*((1u << 31) - 1);
+
+  // Temporary table for op-amp transfer function.
+  unsigned int* voltages = new unsigned int[1 << 16];
+
+  // Create lookup table mapping op-amp voltage across output and input
+  // to input voltage: vo - vx -> vx
+  // FIXME: No variable length arrays in ISO C++, hardcoding to max 50
+  // points.
+  // double_point scaled_voltage[fi.opamp_voltage_size];
+  double_point scaled_voltage[50];
+
+  for (int i = 0; i < fi.opamp_voltage_size; i++) {
+    // The target output range is 16 bits, in order to fit in an unsigned
+    // short.
+    //
+    // The y axis is temporarily scaled to 31 bits for maximum accuracy in
+    // the calculated derivative.
+    //
+    // Values are normalized using
+    //
+    //   x_n = m*2^N*(x - xmin)
+    //
+    // and are translated back later (for fixed point math) using
+    //
+    //   m*2^N*x = x_n - m*2^N*xmin
+    //
+    scaled_voltage[fi.opamp_voltage_size - 1 - i][0] = int(N16*(fi.opamp_voltage[i][1] - fi.opamp_voltage[i][0] + denorm)/2 + 0.5);
+    scaled_voltage[fi.opamp_voltage_size - 1 - i][1] = N31*(fi.opamp_voltage[i][0] - vmin);
+  }
+
+  // Clamp x to 16 bits (rounding may cause overflow).
+  if (scaled_voltage[fi.opamp_voltage_size - 1][0] >= (1 << 16)) {
+    // The last point is repeated.
+    scaled_voltage[fi.opamp_voltage_size - 1][0] =
+        scaled_voltage[fi.opamp_voltage_size - 2][0] = (1 << 16) - 1;
+  }
+
+  interpolate(scaled_voltage, scaled_voltage + fi.opamp_voltage_size - 1,
+                PointPlotter<unsigned int>(voltages), 1.0);
+
+  // Store both fn and dfn in the same table.
+  mf.ak = (int)scaled_voltage[0][0];
+  mf.bk = (int)scaled_voltage[fi.opamp_voltage_size - 1][0];
+  int j;
+  for (j = 0; j < mf.ak; j++) {
+    opamp[j].vx = 0;
+    opamp[j].dvx = 0;
+  }
+  unsigned int f = voltages[j];
+  for (; j <= mf.bk; j++) {
+    unsigned int fp = f;
+    f = voltages[j];  // Scaled by m*2^31
+    // m*2^31*dy/1 = (m*2^31*dy)/(m*2^16*dx) = 2^15*dy/dx
+    int df = f - fp;  // Scaled by 2^15
+
+    // 16 bits unsigned: m*2^16*(fn - xmin)
+    opamp[j].vx = f > (0xffff << 15) ? 0xffff : f >> 15;
+    // 16 bits (15 bits + sign bit): 2^11*dfn
+    opamp[j].dvx = df >> (15 - 11);
+  }
+  for (; j < (1 << 16); j++) {
+    opamp[j].vx = 0;
+    opamp[j].dvx = 0;
+  }
+
+  // We don't have the differential for the first point so just assume
+  // it's the same as the second point's
+  opamp[mf.ak].dvx = opamp[mf.ak+1].dvx;
+
+  // Free temporary table.
+  delete[] voltages;
+}
+
+
+// ----------------------------------------------------------------------------
+// Solve the op-amp tables of a chip model, only the first count entries
+// of each table.
+// With check set, the entries in place are compared with the solution
+// instead of being replaced; returns false if any of them differs.
+// ----------------------------------------------------------------------------
+bool Filter::solve_tables(int m, opamp_t* opamp, int count, bool check)
+{
+  model_filter_t& mf = model_filter[m];
+  bool same = true;
+
+  // Create lookup tables for gains / summers.
+
+  // 4 bit "resistor" ladders in the bandpass resonance gain and the audio
+  // output gain necessitate 16 gain tables.
+  // From die photographs of the bandpass and volume "resistor" ladders
+  // it follows that gain ~ vol/8 and 1/Q ~ ~res/8 (assuming ideal
+  // op-amps and ideal "resistors").
+  for (int n8 = 0; n8 < 16; n8++) {
+    int n = n8 << 4;  // Scaled by 2^7
+    int x = mf.ak;
+    for (int vi = 0; vi < (1 << 16) && vi < count; vi++) {
+      same &= store(mf.gain[n8][vi], solve_gain(opamp, n, vi, x, mf), check);
+    }
+  }
+
+  // The filter summer operates at n ~ 1, and has 5 fundamentally different
+  // input configurations (2 - 6 input "resistors").
+  //
+  // Note that all "on" transistors are modeled as one. This is not
+  // entirely accurate, since the input for each transistor is different,
+  // and transistors are not linear components. However modeling all
+  // transistors separately would be extremely costly.
+  int offset = 0;
+  int size;
+  for (int k = 0; k < 5; k++) {
+    int idiv = 2 + k;        // 2 - 6 input "resistors".
+    int n_idiv = idiv << 7;  // n*idiv, scaled by 2^7
+    size = idiv << 16;
+    int x = mf.ak;
+    for (int vi = 0; vi < size && vi < count; vi++) {
+      same &= store(mf.summer[offset + vi],
+        solve_gain(opamp, n_idiv, vi/idiv, x, mf), check);
+    }
+    offset += size;
+  }
+
+  // The audio mixer operates at n ~ 8/6, and has 8 fundamentally different
+  // input configurations (0 - 7 input "resistors").
+  //
+  // All "on", transistors are modeled as one - see comments above for
+  // the filter summer.
+  offset = 0;
+  size = 1;  // Only one lookup element for 0 input "resistors".
+  for (int l = 0; l < 8; l++) {
+    int idiv = l;                 // 0 - 7 input "resistors".
+    int n_idiv = (idiv << 7)*8/6; // n*idiv, scaled by 2^7
+    if (idiv == 0) {
+      // Avoid division by zero; the result will be correct since
+      // n_idiv = 0.
+      idiv = 1;
+    }
+    int x = mf.ak;
+    for (int vi = 0; vi < size && vi < count; vi++) {
+      same &= store(mf.mixer[offset + vi],
+        solve_gain(opamp, n_idiv, vi/idiv, x, mf), check);
+    }
+    offset += size;
+    size = (l + 1) << 16;
+  }
+
+  if (m == 1) {
+    // 8580 only
+    for (int n8 = 0; n8 < 16; n8++) {
+      int x = mf.ak;
+      for (int vi = 0; vi < (1 << 16) && vi < count; vi++) {
+        same &= store(resonance[n8][vi], solve_gain(opamp, resGain[n8], vi, x, mf), check);
+      }
+    }
+  }
+
+  return same;
+}
+
+
+// ----------------------------------------------------------------------------
+// The op-amp tables of a chip model, as laid out in the baked image.
+// Returns the number of tables.
+// ----------------------------------------------------------------------------
+int Filter::opamp_tables(int m, unsigned short* data[], unsigned int size[])
+{
+  model_filter_t& mf = model_filter[m];
+  int n = 0;
+
+  data[n] = mf.gain[0];
+  size[n++] = 16 << 16;
+  data[n] = mf.summer;
+  size[n++] = summer_offset<5>::value;
+  data[n] = mf.mixer;
+  size[n++] = mixer_offset<8>::value;
+
+  if (m == 1) {
+    data[n] = resonance[0];
+    size[n++] = 16 << 16;
+  }
+
+  return n;
+}
+
+
+// ----------------------------------------------------------------------------
+// Hash of what the op-amp tables of a chip model are solved from.
+// The op-amp transfer table is calculated in floating point, so it is
+// hashed whole: an image baked where it comes out different is not used.
+// ----------------------------------------------------------------------------
+unsigned int Filter::tables_fingerprint(int m, const opamp_t* opamp)
+{
+  model_filter_init_t& fi = model_filter_init[m];
+  model_filter_t& mf = model_filter[m];
+
+  uint32_t key = TableCache::hash(fi.opamp_voltage, fi.opamp_voltage_size*sizeof(*fi.opamp_voltage));
+  key = TableCache::hash(&mf.vo_N16, sizeof(mf.vo_N16), key);
+  key = TableCache::hash(&mf.kVddt, sizeof(mf.kVddt), key);
+  key = TableCache::hash(&mf.ak, sizeof(mf.ak), key);
+  key = TableCache::hash(&mf.bk, sizeof(mf.bk), key);
+  key = TableCache::hash(opamp, (1 << 16)*sizeof(*opamp), key);
+  if (m == 1) {
+    key = TableCache::hash(resGain, sizeof(resGain), key);
+  }
+
+  unsigned short* data[4];
+  unsigned int size[4];
+  int n = opamp_tables(m, data, size);
+  return TableCache::hash(size, n*sizeof(*size), key);
+}
+
+
+// ----------------------------------------------------------------------------
+// Build the lookup tables of a chip model, if not already done.
+// ----------------------------------------------------------------------------
+void Filter::init_model(chip_model model)
+{
+  if (model_init[model]) {
+    return;
+  }
+
+  model_filter_t& mf = model_filter[model];
+
+  // Temporary table for op-amp transfer function.
+  opamp_t* opamp = new opamp_t[1 << 16];
+  opamp_table(model, opamp);
+
+  // Solving the op-amp tables is slow, so they are baked into the library
+  // at build time. The image is only used if it was made for the same model
+  // and agrees with the solver.
+  unsigned short* data[4];
+  unsigned int size[4];
+  std::vector<TableImage::table_t> tables;
+  image_tables(tables, data, size, opamp_tables(model, data, size));
+
+  const bool baked = model == MOS6581 ?
+    TableImage::decode(tables, tables_fingerprint(model, opamp), filter_image_6581, filter_image_6581_size) :
+    TableImage::decode(tables, tables_fingerprint(model, opamp), filter_image_8580, filter_image_8580_size);
+
+  if (!baked || !solve_tables(model, opamp, CHECK_ENTRIES, true)) {
+    solve_tables(model, opamp, INT_MAX, false);
+  }
+
+  // Create lookup table mapping capacitor voltage to op-amp input voltage:
+  // vc -> vx
+  for (int i = 0; i < (1 << 16); i++) {
+    mf.opamp_rev[i] = opamp[i].vx;
+  }
+
+  // Free temporary table.
+  delete[] opamp;
+
+  if (model == MOS6581) {
+    model_filter_init_t& fi = model_filter_init[0];
+    double N16 = mf.vo_N16;
+    double vmin = fi.opamp_voltage[0][0];
+
+    // VCR table.
+    double k = fi.k;
+    double kVddt = N16*(k*(fi.Vdd - fi.Vth));
+    vmin *= N16;
+
+    for (int i = 0; i < (1 << 16); i++) {
+      // The table index is right-shifted 16 times in order to fit in
+      // 16 bits; the argument to sqrt is thus multiplied by (1 << 16).
+      //
+      // The returned value must be corrected for translation. Vg always
+      // takes part in a subtraction as follows:
+      //
+      //   k*Vg - Vx = (k*Vg - t) - (Vx - t)
+      //
+      // I.e. k*Vg - t must be returned.
+      double Vg = kVddt - sqrt((double)i*(1 << 16));
+      vcr_kVg[i] = (unsigned short)(k*Vg - vmin + 0.5);
+    }
+
+    /*
+      EKV model:
+
+      Ids = Is*(if - ir)
+      Is = ((2*u*Cox*Ut^2)/k)*W/L
+      if = ln^2(1 + e^((k*(Vg - Vt) - Vs)/(2*Ut))
+      ir = ln^2(1 + e^((k*(Vg - Vt) - Vd)/(2*Ut))
+    */
+    double kVt = fi.k*fi.Vth;
+    double Ut = fi.Ut;
+    double Is = ((2*fi.uCox*Ut*Ut)/fi.k)*fi.WL_vcr;
+    // Normalized current factor for 1 cycle at 1MHz.
+    double N15 = N16/2;
+    double n_Is = N15*1.0e-6/fi.C*Is;
+
+    // kVg_Vx = k*Vg - Vx
+    // I.e. if k != 1.0, Vg must be scaled accordingly.
+    for (int kVg_Vx = 0; kVg_Vx < (1 << 16); kVg_Vx++) {
+      double log_term = log1p(exp((kVg_Vx/N16 - kVt)/(2*Ut)));
+      // Scaled by m*2^15
+      vcr_n_Ids_term[kVg_Vx] = (unsigned short)(n_Is*log_term*log_term);
+    }
+  }
+
+  model_init[model] = true;
+}
+
+
+// ----------------------------------------------------------------------------
+// Encode the op-amp tables of a chip model, for baking them into the library.
+// ----------------------------------------------------------------------------
+void Filter::encode_tables(chip_model model, std::vector<unsigned char>& image)
+{
+  init_model(model);
+
+  unsigned short* data[4];
+  unsigned int size[4];
+  std::vector<TableImage::table_t> tables;
+  image_tables(tables, data, size, opamp_tables(model, data, size));
+
+  opamp_t* opamp = new opamp_t[1 << 16];
+  opamp_table(model, opamp);
+  TableImage::encode(tables, tables_fingerprint(model, opamp), image);
+  delete[] opamp;
 }
 
 
@@ -579,6 +774,8 @@ void Filter::adjust_filter_bias(double dac_bias)
 // ----------------------------------------------------------------------------
 void Filter::set_chip_model(chip_model model)
 {
+  init_model(model);
+
   sid_model = model;
   /* We initialize the state variables again just to make sure that
    * the earlier model didn't leave behind some foreign, unrecoverable
@@ -22,6 +22,9 @@
 
 #include "resid-config.h"
 
+#include <stddef.h>
+#include <vector>
+
 namespace reSID
 {
 
@@ -548,6 +551,10 @@ public:
   // SID audio output (16 bits).
   short output();
 
+  // Encode the op-amp tables of a chip model, for baking them into the
+  // library at build time. A Filter must have been constructed first.
+  static void encode_tables(chip_model model, std::vector<unsigned char>& image);
+
 protected:
   void set_sum_mix();
   void set_w0();
@@ -637,7 +644,7 @@ protected:
   // Lookup tables for resonance
   static unsigned short resonance[16][1 << 16];
 
-  int solve_gain(opamp_t* opamp, int n, int vi_t, int& x, model_filter_t& mf);
+  static int solve_gain(opamp_t* opamp, int n, int vi_t, int& x, model_filter_t& mf);
   int solve_integrate_6581(int dt, int vi_t, int& x, int& vc, model_filter_t& mf);
   int solve_integrate_8580(int dt, int vi_t, int& x, int& vc, model_filter_t& mf);
 
@@ -647,9 +654,26 @@ protected:
   // Common parameters.
   static model_filter_t model_filter[2];
 
+  // The lookup tables are built for each chip model when the model is
+  // first used, most programs never use both.
+  static bool model_init[2];
+
+  static void init_model(chip_model model);
+  static void opamp_table(int m, opamp_t* opamp);
+  static bool solve_tables(int m, opamp_t* opamp, int count, bool check);
+  static int opamp_tables(int m, unsigned short* data[], unsigned int size[]);
+  static unsigned int tables_fingerprint(int m, const opamp_t* opamp);
+
 friend class SID;
 };
 
+// Op-amp tables baked at build time by mkfiltertables,
+// unusable if they could not be generated.
+extern const unsigned char filter_image_6581[];
+extern const size_t filter_image_6581_size;
+extern const unsigned char filter_image_8580[];
+extern const size_t filter_image_8580_size;
+
 
 // ----------------------------------------------------------------------------
 // Inline functions.
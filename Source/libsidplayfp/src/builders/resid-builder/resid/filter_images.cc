@@ -0,0 +1,40 @@
+//  ---------------------------------------------------------------------------
+//  This file is part of reSID, a MOS6581 SID emulator engine.
+//  Copyright (C) 2010  Dag Lem <resid@nimrod.no>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//  ---------------------------------------------------------------------------
+
+#include "filter8580new.h"
+
+namespace reSID
+{
+
+// Generated by mkfiltertables
+const unsigned char filter_image_6581[] =
+{
+#include "filter6581.bin"
+};
+
+const size_t filter_image_6581_size = sizeof(filter_image_6581);
+
+const unsigned char filter_image_8580[] =
+{
+#include "filter8580.bin"
+};
+
+const size_t filter_image_8580_size = sizeof(filter_image_8580);
+
+} // namespace reSID
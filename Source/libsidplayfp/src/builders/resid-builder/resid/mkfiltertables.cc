@@ -0,0 +1,70 @@
+//  ---------------------------------------------------------------------------
+//  This file is part of reSID, a MOS6581 SID emulator engine.
+//  Copyright (C) 2010  Dag Lem <resid@nimrod.no>
+//
+//  This program is free software; you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation; either version 2 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//  ---------------------------------------------------------------------------
+
+// Build time generator of the filter op-amp table images.
+//
+// Usage: mkfiltertables 6581|8580
+//
+// Writes the image as a list of comma separated bytes
+// to be included in an array.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "filter8580new.h"
+
+namespace reSID
+{
+
+// No images yet, the tables are solved.
+const unsigned char filter_image_6581[] = { 0 };
+const size_t filter_image_6581_size = 0;
+const unsigned char filter_image_8580[] = { 0 };
+const size_t filter_image_8580_size = 0;
+
+}
+
+using namespace reSID;
+
+int main(int argc, char *argv[])
+{
+  std::vector<unsigned char> image;
+
+  // Set up the model parameters.
+  Filter filter;
+
+  if ((argc == 2) && !strcmp(argv[1], "6581")) {
+    Filter::encode_tables(MOS6581, image);
+  }
+  else if ((argc == 2) && !strcmp(argv[1], "8580")) {
+    Filter::encode_tables(MOS8580, image);
+  }
+  else {
+    fprintf(stderr, "Usage: %s 6581|8580\n", argv[0]);
+    return 1;
+  }
+
+  for (size_t i = 0; i < image.size(); i++) {
+    printf((i % 16 == 15) ? "0x%02x,\n" : "0x%02x,", image[i]);
+  }
+  printf("\n");
+
+  return ferror(stdout) ? 1 : 0;
+}
@@ -25,6 +25,7 @@
 #endif
 
 #include "sid.h"
+#include "dot.h"
 #include <math.h>
 
 #ifndef round
@@ -677,6 +678,8 @@ void SID::adjust_sampling_frequency(double sample_freq)
 
 // ----------------------------------------------------------------------------
 // SID clocking - delta_t cycles.
+// The filter tables must have been built, by set_chip_model() or by
+// clocking with audio sampling.
 // ----------------------------------------------------------------------------
 void SID::clock(cycle_count delta_t)
 {
@@ -784,6 +787,12 @@ void SID::clock(cycle_count delta_t)
 // ----------------------------------------------------------------------------
 int SID::clock(cycle_count& delta_t, short* buf, int n, int interleave)
 {
+  // The filter tables are built when a chip model is selected,
+  // or here if the default model is used.
+  if (unlikely(!Filter::model_init[filter.sid_model])) {
+    Filter::init_model(filter.sid_model);
+  }
+
   switch (sampling) {
   default:
   case SAMPLE_FAST:
@@ -939,10 +948,7 @@ int SID::clock_resample(cycle_count& delta_t, short* buf, int n, int interleave)
     short* sample_start = sample + sample_index - fir_N - 1 + RINGSIZE;
 
     // Convolution with filter impulse response.
-    int v1 = 0;
-    for (int j = 0; j < fir_N; j++) {
-      v1 += sample_start[j]*fir_start[j];
-    }
+    int v1 = dot_product(sample_start, fir_start, fir_N);
 
     // Use next FIR table, wrap around to first FIR table using
     // next sample.
@@ -953,10 +959,7 @@ int SID::clock_resample(cycle_count& delta_t, short* buf, int n, int interleave)
     fir_start = fir + fir_offset*fir_N;
 
     // Convolution with filter impulse response.
-    int v2 = 0;
-    for (int k = 0; k < fir_N; k++) {
-      v2 += sample_start[k]*fir_start[k];
-    }
+    int v2 = dot_product(sample_start, fir_start, fir_N);
 
     // Linear interpolation.
     // fir_offset_rmd is equal for all samples, it can thus be factorized out:
@@ -1005,10 +1008,7 @@ int SID::clock_resample_fastmem(cycle_count& delta_t, short* buf, int n, int int
     short* sample_start = sample + sample_index - fir_N + RINGSIZE;
 
     // Convolution with filter impulse response.
-    int v = 0;
-    for (int j = 0; j < fir_N; j++) {
-      v += sample_start[j]*fir_start[j];
-    }
+    int v = dot_product(sample_start, fir_start, fir_N);
 
     v >>= FIR_SHIFT;
 
@@ -188,6 +188,7 @@ int SID::output()
 
 // ----------------------------------------------------------------------------
 // SID clocking - 1 cycle.
+// The filter tables must have been built, see SID::clock(cycle_count).
 // ----------------------------------------------------------------------------
 RESID_INLINE
 void SID::clock()
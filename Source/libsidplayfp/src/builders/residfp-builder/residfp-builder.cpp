@@ -26,6 +26,7 @@
 #include <new>
 
 #include "residfp-emu.h"
+#include "residfp/TableCache.h"
 
 ReSIDfpBuilder::~ReSIDfpBuilder()
 {   // Remove all SID emulations
@@ -80,3 +81,8 @@ void ReSIDfpBuilder::filter8580Curve(double filterCurve)
 {
     std::for_each(sidobjs.begin(), sidobjs.end(), applyParameter<libsidplayfp::ReSIDfp, double>(&libsidplayfp::ReSIDfp::filter8580Curve, filterCurve));
 }
+
+void ReSIDfpBuilder::tableCache(const char *directory)
+{
+    reSIDfp::TableCache::setDirectory(directory);
+}
@@ -113,7 +113,8 @@ void ReSIDfp::filter(bool enable)
 }
 
 void ReSIDfp::sampling(float systemclock, float freq,
-        SidConfig::sampling_method_t method, bool)
+        SidConfig::sampling_method_t method, bool,
+        SidConfig::sampling_quality_t quality)
 {
     reSIDfp::SamplingMethod sampleMethod;
     switch (method)
@@ -130,10 +131,27 @@ void ReSIDfp::sampling(float systemclock, float freq,
         return;
     }
 
+    int halfFreq;
+    int precision;
+    switch (quality)
+    {
+    case SidConfig::HIGH_QUALITY:
+        halfFreq = (freq > 44000) ? 20000 : 9 * freq / 20;
+        precision = 16;
+        break;
+    case SidConfig::LOW_QUALITY:
+        halfFreq = (freq > 40000) ? 16000 : 2 * freq / 5;
+        precision = 10;
+        break;
+    default:
+        m_status = false;
+        m_error = ERR_INVALID_SAMPLING;
+        return;
+    }
+
     try
     {
-        const int halfFreq = (freq > 44000) ? 20000 : 9 * freq / 20;
-        m_sid.setSamplingParameters(systemclock, sampleMethod, freq, halfFreq);
+        m_sid.setSamplingParameters(systemclock, sampleMethod, freq, halfFreq, precision);
     }
     catch (reSIDfp::SIDError const &)
     {
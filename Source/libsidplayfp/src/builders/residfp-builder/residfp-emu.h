@@ -62,7 +62,8 @@ public:
     void clock() override;
 
     void sampling(float systemclock, float freq,
-        SidConfig::sampling_method_t method, bool) override;
+        SidConfig::sampling_method_t method, bool,
+        SidConfig::sampling_quality_t quality) override;
 
     void voice(unsigned int num, bool mute) override { m_sid.mute(num, mute); }
 
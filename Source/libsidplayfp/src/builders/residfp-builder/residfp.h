@@ -73,6 +73,19 @@ public:
      * @param filterCurve curve center frequency (default 12500)
      */
     void filter8580Curve(double filterCurve);
+
+    /**
+     * Set a directory where the lookup tables are cached
+     * and shared with other processes.
+     * Must be called before creating the SIDs.
+     *
+     * The tables are used straight from the files, which may be
+     * deleted but must not be truncated or rewritten in place
+     * while a process is using them, or it crashes with SIGBUS.
+     *
+     * @param directory an existing directory, null or empty to disable the cache
+     */
+    static void tableCache(const char *directory);
     //@}
 };
 
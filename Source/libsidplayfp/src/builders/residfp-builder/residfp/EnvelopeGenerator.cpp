@@ -63,14 +63,179 @@ const unsigned int EnvelopeGenerator::adsrtable[16] =
     0x64a8
 };
 
+/**
+ * The envelope DAC tables of both chip models.
+ */
+class EnvelopeDac
+{
+public:
+    float table6581[1 << DAC_BITS];
+    float table8580[1 << DAC_BITS];
+
+private:
+    static void build(ChipModel chipModel, float* table)
+    {
+        Dac dacBuilder(DAC_BITS);
+        dacBuilder.kinkedDac(chipModel);
+
+        for (unsigned int i = 0; i < (1 << DAC_BITS); i++)
+        {
+            table[i] = static_cast<float>(dacBuilder.getOutput(i));
+        }
+    }
+
+public:
+    EnvelopeDac()
+    {
+        build(MOS6581, table6581);
+        build(MOS8580, table8580);
+    }
+};
+
+const float* EnvelopeGenerator::dacTable(ChipModel chipModel)
+{
+    static const EnvelopeDac dacs;
+    return chipModel == MOS6581 ? dacs.table6581 : dacs.table8580;
+}
+
 void EnvelopeGenerator::setChipModel(ChipModel chipModel)
 {
-    Dac dacBuilder(DAC_BITS);
-    dacBuilder.kinkedDac(chipModel);
+    dac = dacTable(chipModel);
+}
+
+/// The LFSR runs through all the 15 bit values but zero.
+const unsigned int LFSR_PERIOD = 0x7fff;
+
+/**
+ * The sequence of the rate counter LFSR starting from 0x7fff,
+ * and the position of each value in it.
+ */
+class LfsrSequence
+{
+public:
+    unsigned short value[LFSR_PERIOD];
+    unsigned short index[LFSR_PERIOD + 1];
+
+public:
+    LfsrSequence()
+    {
+        // Zero is never reached
+        index[0] = 0;
+
+        unsigned int lfsr = 0x7fff;
+
+        for (unsigned int i = 0; i < LFSR_PERIOD; i++)
+        {
+            value[i] = lfsr;
+            index[lfsr] = i;
+            lfsr = EnvelopeGenerator::clockLfsr(lfsr);
+        }
+    }
+};
+
+static const LfsrSequence &lfsrSequence()
+{
+    static const LfsrSequence sequence;
+    return sequence;
+}
+
+bool EnvelopeGenerator::isFrozen() const
+{
+    // Released down to zero. In the attack state the frozen counter
+    // may still be restarted by the rate counter.
+    return !counter_enabled
+        && state != ATTACK
+        && state_pipeline == 0
+        && envelope_pipeline == 0
+        && exponential_pipeline == 0
+        && new_exponential_counter_period == 0
+        && rate != 0;
+}
+
+unsigned int EnvelopeGenerator::idleCycles() const
+{
+    if (isFrozen())
+        return ~0u;
+
+    if (state_pipeline != 0
+        || envelope_pipeline != 0
+        || exponential_pipeline != 0
+        || new_exponential_counter_period != 0
+        || resetLfsr)
+    {
+        return 0;
+    }
+
+    // Before the first register write the comparison value is never matched
+    if (unlikely(rate == 0))
+        return ~0u;
+
+    // The cycle that matches the comparison value triggers the next event
+    const LfsrSequence &sequence = lfsrSequence();
+    return (sequence.index[rate] + LFSR_PERIOD - sequence.index[lfsr]) % LFSR_PERIOD;
+}
+
+void EnvelopeGenerator::skip(unsigned int cycles)
+{
+    const LfsrSequence &sequence = lfsrSequence();
+    lfsr = sequence.value[(sequence.index[lfsr] + cycles) % LFSR_PERIOD];
+
+    env3 = envelope_counter;
+}
+
+void EnvelopeGenerator::skipFrozen(unsigned int cycles)
+{
+    const LfsrSequence &sequence = lfsrSequence();
+    const unsigned int match = sequence.index[rate];
+
+    // Position in the loop: 0 at the comparison value, 1 when the
+    // rate counter is reset, then the values following 0x7fff.
+    unsigned int position = 1;
+
+    if (!resetLfsr)
+    {
+        const unsigned int distance = (match + LFSR_PERIOD - sequence.index[lfsr]) % LFSR_PERIOD;
+        if (cycles <= distance)
+        {
+            skip(cycles);
+            return;
+        }
+
+        cycles -= distance;
+        position = 0;
+    }
+
+    position = (position + cycles) % (match + 1);
 
-    for (unsigned int i = 0; i < (1 << DAC_BITS); i++)
+    lfsr = position < 2 ? rate : sequence.value[position - 1];
+    resetLfsr = position == 1;
+
+    env3 = envelope_counter;
+}
+
+void EnvelopeGenerator::clock(unsigned int cycles)
+{
+    while (cycles != 0)
     {
-        dac[i] = static_cast<float>(dacBuilder.getOutput(i));
+        if (isFrozen())
+        {
+            skipFrozen(cycles);
+            return;
+        }
+
+        const unsigned int idle = idleCycles();
+
+        if (idle != 0)
+        {
+            const unsigned int n = idle < cycles ? idle : cycles;
+            skip(n);
+            cycles -= n;
+        }
+        else
+        {
+            clock();
+            cycles--;
+        }
     }
 }
 
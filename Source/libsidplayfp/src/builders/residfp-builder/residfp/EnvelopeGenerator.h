@@ -111,11 +111,12 @@ private:
     unsigned char env3;
 
     /**
-     * Emulated nonlinearity of the envelope DAC.
+     * Emulated nonlinearity of the envelope DAC,
+     * the table of the chip model shared by all voices.
      *
      * @See Dac
      */
-    float dac[256];
+    const float* dac;
 
 private:
     static const unsigned int adsrtable[16];
@@ -125,7 +126,46 @@ private:
 
     void state_change();
 
+    /**
+     * Get the DAC table of a chip model.
+     *
+     * @param chipModel the chip model
+     * @return 256 output levels
+     */
+    static const float* dacTable(ChipModel chipModel);
+
+    /**
+     * Advance the rate counter in closed form.
+     *
+     * @param cycles number of cycles, not more than idleCycles()
+     */
+    void skip(unsigned int cycles);
+
+    /**
+     * Check whether the envelope counter is frozen at zero
+     * until the next register write.
+     */
+    bool isFrozen() const;
+
+    /**
+     * Advance the rate counter of a frozen envelope in closed form.
+     * It keeps looping up to the comparison value and back to 0x7fff.
+     *
+     * @param cycles number of cycles
+     */
+    void skipFrozen(unsigned int cycles);
+
 public:
+    /**
+     * Clock the rate counter LFSR once
+     * by performing XOR on last 2 bits.
+     */
+    static unsigned int clockLfsr(unsigned int lfsr)
+    {
+        const unsigned int feedback = ((lfsr << 14) ^ (lfsr << 13)) & 0x4000;
+        return (lfsr >> 1) | feedback;
+    }
+
     /**
      * Set chip model.
      * This determines the type of the analog DAC emulation:
@@ -140,6 +180,24 @@ public:
      */
     void clock();
 
+    /**
+     * Clock the envelope for a number of cycles.
+     * Idle stretches, where only the rate counter advances,
+     * are skipped in a single step.
+     *
+     * @param cycles number of cycles
+     */
+    void clock(unsigned int cycles);
+
+    /**
+     * Get the number of cycles before the envelope can change state.
+     * Until then only the rate counter advances, towards the comparison value.
+     *
+     * @return the idle cycles, zero if the envelope is busy,
+     *         ~0u if it can't change until a register write
+     */
+    unsigned int idleCycles() const;
+
     /**
      * Get the Envelope Generator output.
      * DAC imperfections are emulated by using envelope_counter as an index
@@ -169,7 +227,8 @@ public:
         decay(0),
         sustain(0),
         release(0),
-        env3(0)
+        env3(0),
+        dac(dacTable(MOS6581))
     {}
 
     /**
@@ -306,9 +365,7 @@ void EnvelopeGenerator::clock()
     if (likely(lfsr != rate))
     {
         // it wasn't a match, clock the LFSR once
-        // by performing XOR on last 2 bits
-        const unsigned int feedback = ((lfsr << 14) ^ (lfsr << 13)) & 0x4000;
-        lfsr = (lfsr >> 1) | feedback;
+        lfsr = clockLfsr(lfsr);
     }
     else
     {
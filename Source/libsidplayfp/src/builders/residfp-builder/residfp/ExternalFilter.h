@@ -80,6 +80,19 @@ public:
      */
     int clock(unsigned short input);
 
+    /**
+     * Check whether clocking with the given input leaves the filter
+     * state, and so the output, unchanged.
+     *
+     * @param input
+     */
+    bool isSettled(unsigned short input) const
+    {
+        const int Vi = (static_cast<unsigned int>(input)<<11) - (1 << (11+15));
+        return (w0lp_1_s7 * (Vi - Vlp) >> 7) == 0
+            && (w0hp_1_s17 * (Vlp - Vhp) >> 17) == 0;
+    }
+
     /**
      * Constructor.
      */
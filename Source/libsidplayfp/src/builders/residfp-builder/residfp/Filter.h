@@ -23,6 +23,8 @@
 #ifndef FILTER_H
 #define FILTER_H
 
+#include <type_traits>
+
 namespace reSIDfp
 {
 
@@ -32,6 +34,21 @@ namespace reSIDfp
 class Filter
 {
 protected:
+    /**
+     * Routing of the voices and of the filter outputs, see routing().
+     */
+    enum
+    {
+        ROUTE_FILT1 = 0x01,     ///< voice 1 through the filter
+        ROUTE_FILT2 = 0x02,     ///< voice 2 through the filter
+        ROUTE_FILT3 = 0x04,     ///< voice 3 through the filter
+        ROUTE_DIRECT3 = 0x08,   ///< voice 3 to the mixer, not switched off
+        ROUTE_LP = 0x10,        ///< lowpass output to the mixer
+        ROUTE_BP = 0x20,        ///< bandpass output to the mixer
+        ROUTE_HP = 0x40,        ///< highpass output to the mixer
+        ROUTINGS = 0x80
+    };
+
     /// Current volume amplifier setting.
     unsigned short* currentGain;
 
@@ -119,6 +136,29 @@ public:
 
     virtual ~Filter() {}
 
+    /**
+     * Filter state, see getState().
+     */
+    typedef struct
+    {
+        int Vhp;
+        int Vbp;
+        int Vlp;
+        int hpVx;
+        int hpVc;
+        int bpVx;
+        int bpVc;
+    } state_t;
+
+    /**
+     * Get the filter state. When a cycle leaves it unchanged the filter
+     * has settled, and keeps the same output until the input or the
+     * registers change.
+     *
+     * @param state the current state
+     */
+    virtual void getState(state_t &state) const = 0;
+
     /**
      * SID clocking - 1 cycle
      *
@@ -129,6 +169,20 @@ public:
      */
     virtual unsigned short clock(int v1, int v2, int v3) = 0;
 
+    /**
+     * SID clocking - a block of cycles.
+     *
+     * The routing can't change within the block, so it is
+     * resolved once for all the cycles.
+     *
+     * @param v1 voice 1 in, for each cycle
+     * @param v2 voice 2 in, for each cycle
+     * @param v3 voice 3 in, for each cycle
+     * @param out filtered output, for each cycle
+     * @param cycles number of cycles
+     */
+    virtual void clock(const int* v1, const int* v2, const int* v3, unsigned short* out, unsigned int cycles) = 0;
+
     /**
      * Enable filter.
      *
@@ -170,6 +224,52 @@ public:
     void writeMODE_VOL(unsigned char mode_vol);
 
     virtual void input(int input) = 0;
+
+protected:
+    /**
+     * Get the current routing.
+     *
+     * @return a combination of the ROUTE_* flags
+     */
+    unsigned int routing() const
+    {
+        return (filt1 ? ROUTE_FILT1 : 0)
+            | (filt2 ? ROUTE_FILT2 : 0)
+            | (filt3 ? ROUTE_FILT3 : (voice3off ? 0 : ROUTE_DIRECT3))
+            | (lp ? ROUTE_LP : 0)
+            | (bp ? ROUTE_BP : 0)
+            | (hp ? ROUTE_HP : 0);
+    }
+};
+
+/**
+ * The block clocking functions of a filter model, one for each routing.
+ * F::clockRouted<routing> is instantiated for all the routings,
+ * so that the checks are resolved at compile time.
+ */
+template<class F>
+class FilterRoutings
+{
+public:
+    typedef void (F::*block_t)(const int* v1, const int* v2, const int* v3, unsigned short* out, unsigned int cycles);
+
+private:
+    block_t blocks[F::ROUTINGS];
+
+private:
+    template<unsigned int N>
+    void fill(std::integral_constant<unsigned int, N>)
+    {
+        blocks[N - 1] = &F::template clockRouted<N - 1>;
+        fill(std::integral_constant<unsigned int, N - 1>());
+    }
+
+    void fill(std::integral_constant<unsigned int, 0>) {}
+
+public:
+    FilterRoutings() { fill(std::integral_constant<unsigned int, F::ROUTINGS>()); }
+
+    block_t get(unsigned int routing) const { return blocks[routing]; }
 };
 
 } // namespace reSIDfp
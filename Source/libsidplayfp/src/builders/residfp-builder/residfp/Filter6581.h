@@ -337,6 +337,15 @@ private:
     /// VCR + associated capacitor connected to bandpass output.
     std::unique_ptr<Integrator6581> const bpIntegrator;
 
+    friend class FilterRoutings<Filter6581>;
+
+private:
+    /**
+     * Clock a block of cycles with a given routing.
+     */
+    template<unsigned int routing>
+    void clockRouted(const int* v1, const int* v2, const int* v3, unsigned short* out, unsigned int cycles);
+
 protected:
     /**
      * Set filter cutoff frequency.
@@ -370,6 +379,10 @@ public:
 
     unsigned short clock(int voice1, int voice2, int voice3) override;
 
+    void clock(const int* v1, const int* v2, const int* v3, unsigned short* out, unsigned int cycles) override;
+
+    void getState(state_t &state) const override;
+
     void input(int sample) override { ve = (sample * voiceScaleS11 * 3 >> 11) + mixer[0][0]; }
 
     /**
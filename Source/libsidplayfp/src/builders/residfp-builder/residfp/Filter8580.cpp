@@ -98,4 +98,76 @@ void Filter8580::setFilterCurve(double curvePosition)
     bpIntegrator->setV(cp);
 }
 
+void Filter8580::getState(state_t &state) const
+{
+    state.Vhp = Vhp;
+    state.Vbp = Vbp;
+    state.Vlp = Vlp;
+    state.hpVx = hpIntegrator->getVx();
+    state.hpVc = hpIntegrator->getVc();
+    state.bpVx = bpIntegrator->getVx();
+    state.bpVc = bpIntegrator->getVc();
+}
+
+template<unsigned int routing>
+void Filter8580::clockRouted(const int* v1, const int* v2, const int* v3, unsigned short* out, unsigned int cycles)
+{
+    const bool filt1 = (routing & ROUTE_FILT1) != 0;
+    const bool filt2 = (routing & ROUTE_FILT2) != 0;
+    const bool filt3 = (routing & ROUTE_FILT3) != 0;
+    const bool direct3 = (routing & ROUTE_DIRECT3) != 0;
+    const bool lp = (routing & ROUTE_LP) != 0;
+    const bool bp = (routing & ROUTE_BP) != 0;
+    const bool hp = (routing & ROUTE_HP) != 0;
+
+    // The voice DC and the external input are the same for all the cycles
+    int Vi0 = 0;
+    int Vo0 = 0;
+
+    (filt1 ? Vi0 : Vo0) += voiceDC;
+    (filt2 ? Vi0 : Vo0) += voiceDC;
+    if (filt3) Vi0 += voiceDC;
+    if (direct3) Vo0 += voiceDC;
+    (filtE ? Vi0 : Vo0) += ve;
+
+    const Integrator8580* const hpIntegrator = this->hpIntegrator.get();
+    const Integrator8580* const bpIntegrator = this->bpIntegrator.get();
+
+    int Vhp = this->Vhp;
+    int Vbp = this->Vbp;
+    int Vlp = this->Vlp;
+
+    for (unsigned int i = 0; i < cycles; i++)
+    {
+        int Vi = Vi0;
+        int Vo = Vo0;
+
+        (filt1 ? Vi : Vo) += v1[i] * voiceScaleS11 >> 15;
+        (filt2 ? Vi : Vo) += v2[i] * voiceScaleS11 >> 15;
+        if (filt3) Vi += v3[i] * voiceScaleS11 >> 15;
+        if (direct3) Vo += v3[i] * voiceScaleS11 >> 15;
+
+        Vhp = currentSummer[currentResonance[Vbp] + Vlp + Vi];
+        Vbp = hpIntegrator->solve(Vhp);
+        Vlp = bpIntegrator->solve(Vbp);
+
+        if (lp) Vo += Vlp;
+        if (bp) Vo += Vbp;
+        if (hp) Vo += Vhp;
+
+        out[i] = currentGain[currentMixer[Vo]];
+    }
+
+    this->Vhp = Vhp;
+    this->Vbp = Vbp;
+    this->Vlp = Vlp;
+}
+
+void Filter8580::clock(const int* v1, const int* v2, const int* v3, unsigned short* out, unsigned int cycles)
+{
+    static const FilterRoutings<Filter8580> routings;
+
+    (this->*routings.get(routing()))(v1, v2, v3, out, cycles);
+}
+
 } // namespace reSIDfp
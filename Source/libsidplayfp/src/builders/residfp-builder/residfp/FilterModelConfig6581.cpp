@@ -26,7 +26,7 @@
 #include <cassert>
 
 #include "Integrator6581.h"
-#include "OpAmp.h"
+#include "parallel.h"
 
 namespace reSIDfp
 {
@@ -89,6 +89,89 @@ const Spline::Point opamp_voltage[OPAMP_SIZE] =
   { 10.31,  0.81 },  // Approximate end of actual range
 };
 
+/**
+ * Fill a range of the reverse op-amp transfer function.
+ */
+class OpAmpRev6581Task
+{
+private:
+    const Spline::Point *scaled_voltage;
+    unsigned short *opamp_rev;
+
+public:
+    OpAmpRev6581Task(const Spline::Point *scaled_voltage, unsigned short *opamp_rev) :
+        scaled_voltage(scaled_voltage),
+        opamp_rev(opamp_rev) {}
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+        // The spline caches the last interval, so each range needs its own
+        Spline s(scaled_voltage, OPAMP_SIZE);
+
+        for (unsigned int x = begin; x < end; x++)
+        {
+            const Spline::Point out = s.evaluate(x);
+            double tmp = out.x;
+            if (tmp < 0.) tmp = 0.;
+            assert(tmp < 65535.5);
+            opamp_rev[x] = static_cast<unsigned short>(tmp + 0.5);
+        }
+    }
+};
+
+/**
+ * Fill a range of the VCR tables.
+ */
+class Vcr6581Task
+{
+private:
+    const double nVddt;
+    const double nVmin;
+    const double N16;
+    const double n_Is;
+    const double Ut;
+    unsigned short *vcr_Vg;
+    unsigned short *vcr_n_Ids_term;
+
+public:
+    Vcr6581Task(double nVddt, double nVmin, double N16, double n_Is, double Ut,
+            unsigned short *vcr_Vg, unsigned short *vcr_n_Ids_term) :
+        nVddt(nVddt),
+        nVmin(nVmin),
+        N16(N16),
+        n_Is(n_Is),
+        Ut(Ut),
+        vcr_Vg(vcr_Vg),
+        vcr_n_Ids_term(vcr_n_Ids_term) {}
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+        for (unsigned int i = begin; i < end; i++)
+        {
+            // The table index is right-shifted 16 times in order to fit in
+            // 16 bits; the argument to sqrt is thus multiplied by (1 << 16).
+            const double Vg = nVddt - sqrt((double)(i << 16));
+            const double tmp = Vg - nVmin;
+            assert(tmp > -0.5 && tmp < 65535.5);
+            vcr_Vg[i] = static_cast<unsigned short>(tmp + 0.5);
+        }
+
+        // kVgt_Vx = k*(Vg - Vt) - Vx
+        // I.e. if k != 1.0, Vg must be scaled accordingly.
+        for (unsigned int kVgt_Vx = begin; kVgt_Vx < end; kVgt_Vx++)
+        {
+            const double log_term = log1p(exp((kVgt_Vx / N16) / (2. * Ut)));
+            // Scaled by m*2^15
+            const double tmp = n_Is * log_term * log_term;
+            assert(tmp > -0.5 && tmp < 65535.5);
+            vcr_n_Ids_term[kVgt_Vx] = static_cast<unsigned short>(tmp + 0.5);
+        }
+    }
+};
+
+/// Entries per chunk when filling the 16 bit tables in parallel.
+const unsigned int TABLE_GRAIN = 1 << 12;
+
 std::unique_ptr<FilterModelConfig6581> FilterModelConfig6581::instance(nullptr);
 
 FilterModelConfig6581* FilterModelConfig6581::getInstance()
@@ -119,6 +202,7 @@ FilterModelConfig6581::FilterModelConfig6581() :
     denorm(vmax - vmin),
     norm(1.0 / denorm),
     N16(norm * ((1 << 16) - 1)),
+    opampTables(opamp_voltage, OPAMP_SIZE, Vddt, vmin, N16),
     dac(DAC_BITS)
 {
     dac.kinkedDac(MOS6581);
@@ -135,21 +219,10 @@ FilterModelConfig6581::FilterModelConfig6581() :
 
     // Create lookup table mapping capacitor voltage to op-amp input voltage:
 
-    Spline s(scaled_voltage, OPAMP_SIZE);
-
-    for (int x = 0; x < (1 << 16); x++)
-    {
-        const Spline::Point out = s.evaluate(x);
-        double tmp = out.x;
-        if (tmp < 0.) tmp = 0.;
-        assert(tmp < 65535.5);
-        opamp_rev[x] = static_cast<unsigned short>(tmp + 0.5);
-    }
+    parallelFor(OpAmpRev6581Task(scaled_voltage, opamp_rev), 1 << 16, TABLE_GRAIN);
 
     // Create lookup tables for gains / summers.
 
-    OpAmp opampModel(opamp_voltage, OPAMP_SIZE, Vddt);
-
     // The filter summer operates at n ~ 1, and has 5 fundamentally different
     // input configurations (2 - 6 input "resistors").
     //
@@ -161,17 +234,7 @@ FilterModelConfig6581::FilterModelConfig6581() :
     {
         const int idiv = 2 + i;        // 2 - 6 input "resistors".
         const int size = idiv << 16;
-        const double n = idiv;
-        opampModel.reset();
-        summer[i] = new unsigned short[size];
-
-        for (int vi = 0; vi < size; vi++)
-        {
-            const double vin = vmin + vi / N16 / idiv; /* vmin .. vmax */
-            const double tmp = (opampModel.solve(n, vin) - vmin) * N16;
-            assert(tmp > -0.5 && tmp < 65535.5);
-            summer[i][vi] = static_cast<unsigned short>(tmp + 0.5);
-        }
+        opampTables.add(&summer[i], size, idiv, idiv);
     }
 
     // The audio mixer operates at n ~ 8/6, and has 8 fundamentally different
@@ -183,17 +246,7 @@ FilterModelConfig6581::FilterModelConfig6581() :
     {
         const int idiv = (i == 0) ? 1 : i;
         const int size = (i == 0) ? 1 : i << 16;
-        const double n = i * 8.0 / 6.0;
-        opampModel.reset();
-        mixer[i] = new unsigned short[size];
-
-        for (int vi = 0; vi < size; vi++)
-        {
-            const double vin = vmin + vi / N16 / idiv; /* vmin .. vmax */
-            const double tmp = (opampModel.solve(n, vin) - vmin) * N16;
-            assert(tmp > -0.5 && tmp < 65535.5);
-            mixer[i][vi] = static_cast<unsigned short>(tmp + 0.5);
-        }
+        opampTables.add(&mixer[i], size, i * 8.0 / 6.0, idiv);
     }
 
     // 4 bit "resistor" ladders in the bandpass resonance gain and the audio
@@ -204,32 +257,14 @@ FilterModelConfig6581::FilterModelConfig6581() :
     for (int n8 = 0; n8 < 16; n8++)
     {
         const int size = 1 << 16;
-        const double n = n8 / 8.0;
-        opampModel.reset();
-        gain[n8] = new unsigned short[size];
-
-        for (int vi = 0; vi < size; vi++)
-        {
-            const double vin = vmin + vi / N16; /* vmin .. vmax */
-            const double tmp = (opampModel.solve(n, vin) - vmin) * N16;
-            assert(tmp > -0.5 && tmp < 65535.5);
-            gain[n8][vi] = static_cast<unsigned short>(tmp + 0.5);
-        }
+        opampTables.add(&gain[n8], size, n8 / 8.0, 1);
     }
 
+    opampTables.build(filterModelImage6581, filterModelImage6581Size);
+
     const double nVddt = N16 * Vddt;
     const double nVmin = N16 * vmin;
 
-    for (unsigned int i = 0; i < (1 << 16); i++)
-    {
-        // The table index is right-shifted 16 times in order to fit in
-        // 16 bits; the argument to sqrt is thus multiplied by (1 << 16).
-        const double Vg = nVddt - sqrt((double)(i << 16));
-        const double tmp = Vg - nVmin;
-        assert(tmp > -0.5 && tmp < 65535.5);
-        vcr_Vg[i] = static_cast<unsigned short>(tmp + 0.5);
-    }
-
     //  EKV model:
     //
     //  Ids = Is * (if - ir)
@@ -244,35 +279,11 @@ FilterModelConfig6581::FilterModelConfig6581() :
     const double N15 = norm * ((1 << 15) - 1);
     const double n_Is = N15 * 1.0e-6 / C * Is;
 
-    // kVgt_Vx = k*(Vg - Vt) - Vx
-    // I.e. if k != 1.0, Vg must be scaled accordingly.
-    for (int kVgt_Vx = 0; kVgt_Vx < (1 << 16); kVgt_Vx++)
-    {
-        const double log_term = log1p(exp((kVgt_Vx / N16) / (2. * Ut)));
-        // Scaled by m*2^15
-        const double tmp = n_Is * log_term * log_term;
-        assert(tmp > -0.5 && tmp < 65535.5);
-        vcr_n_Ids_term[kVgt_Vx] = static_cast<unsigned short>(tmp + 0.5);
-    }
+    parallelFor(Vcr6581Task(nVddt, nVmin, N16, n_Is, Ut, vcr_Vg, vcr_n_Ids_term), 1 << 16, TABLE_GRAIN);
 }
 
 FilterModelConfig6581::~FilterModelConfig6581()
-{
-    for (int i = 0; i < 5; i++)
-    {
-        delete [] summer[i];
-    }
-
-    for (int i = 0; i < 8; i++)
-    {
-        delete [] mixer[i];
-    }
-
-    for (int i = 0; i < 16; i++)
-    {
-        delete [] gain[i];
-    }
-}
+{}
 
 unsigned short* FilterModelConfig6581::getDAC(double adjustment) const
 {
@@ -27,6 +27,7 @@
 
 #include "Dac.h"
 #include "Spline.h"
+#include "FilterModelTables.h"
 
 #include "sidcxx11.h"
 
@@ -82,6 +83,9 @@ private:
     /// Fixed point scaling for 16 bit op-amp output.
     const double N16;
 
+    /// Builder of the op-amp lookup tables.
+    FilterModelTables opampTables;
+
     /// Lookup tables for gain and summer op-amps in output stage / filter.
     //@{
     unsigned short* mixer[8];
@@ -127,6 +131,11 @@ public:
 
     unsigned short** getMixer() { return mixer; }
 
+    /**
+     * Get the op-amp lookup tables, for baking them at build time.
+     */
+    const FilterModelTables& getOpAmpTables() const { return opampTables; }
+
     /**
      * Construct an 11 bit cutoff frequency DAC output voltage table.
      * Ownership is transferred to the requester which becomes responsible
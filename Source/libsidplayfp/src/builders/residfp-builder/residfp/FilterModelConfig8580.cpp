@@ -25,7 +25,7 @@
 #include <cassert>
 
 #include "Integrator8580.h"
-#include "OpAmp.h"
+#include "parallel.h"
 
 namespace reSIDfp
 {
@@ -109,6 +109,38 @@ const Spline::Point opamp_voltage[OPAMP_SIZE] =
     {  8.91,  1.30 },  // Approximate end of actual range
 };
 
+/**
+ * Fill a range of the reverse op-amp transfer function.
+ */
+class OpAmpRev8580Task
+{
+private:
+    const Spline::Point *scaled_voltage;
+    unsigned short *opamp_rev;
+
+public:
+    OpAmpRev8580Task(const Spline::Point *scaled_voltage, unsigned short *opamp_rev) :
+        scaled_voltage(scaled_voltage),
+        opamp_rev(opamp_rev) {}
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+        // The spline caches the last interval, so each range needs its own
+        Spline s(scaled_voltage, OPAMP_SIZE);
+
+        for (unsigned int x = begin; x < end; x++)
+        {
+            const Spline::Point out = s.evaluate(x);
+            double tmp = out.x;
+            assert(tmp > -0.5 && tmp < 65535.5);
+            opamp_rev[x] = static_cast<unsigned short>(tmp + 0.5);
+        }
+    }
+};
+
+/// Entries per chunk when filling the 16 bit tables in parallel.
+const unsigned int TABLE_GRAIN = 1 << 12;
+
 std::unique_ptr<FilterModelConfig8580> FilterModelConfig8580::instance(nullptr);
 
 FilterModelConfig8580* FilterModelConfig8580::getInstance()
@@ -134,7 +166,8 @@ FilterModelConfig8580::FilterModelConfig8580() :
     vmax(Vddt < opamp_voltage[0].y ? opamp_voltage[0].y : Vddt),
     denorm(vmax - vmin),
     norm(1.0 / denorm),
-    N16(norm * ((1 << 16) - 1))
+    N16(norm * ((1 << 16) - 1)),
+    opampTables(opamp_voltage, OPAMP_SIZE, Vddt, vmin, N16)
 {
     // Convert op-amp voltage transfer to 16 bit values.
 
@@ -148,20 +181,10 @@ FilterModelConfig8580::FilterModelConfig8580() :
 
     // Create lookup table mapping capacitor voltage to op-amp input voltage:
 
-    Spline s(scaled_voltage, OPAMP_SIZE);
-
-    for (int x = 0; x < (1 << 16); x++)
-    {
-        const Spline::Point out = s.evaluate(x);
-        double tmp = out.x;
-        assert(tmp > -0.5 && tmp < 65535.5);
-        opamp_rev[x] = static_cast<unsigned short>(tmp + 0.5);
-    }
+    parallelFor(OpAmpRev8580Task(scaled_voltage, opamp_rev), 1 << 16, TABLE_GRAIN);
 
     // Create lookup tables for gains / summers.
 
-    OpAmp opampModel(opamp_voltage, OPAMP_SIZE, Vddt);
-
     // The filter summer operates at n ~ 1, and has 5 fundamentally different
     // input configurations (2 - 6 input "resistors").
     //
@@ -173,17 +196,7 @@ FilterModelConfig8580::FilterModelConfig8580() :
     {
         const int idiv = 2 + i;        // 2 - 6 input "resistors".
         const int size = idiv << 16;
-        const double n = idiv;
-        opampModel.reset();
-        summer[i] = new unsigned short[size];
-
-        for (int vi = 0; vi < size; vi++)
-        {
-            const double vin = vmin + vi / N16 / idiv; /* vmin .. vmax */
-            const double tmp = (opampModel.solve(n, vin) - vmin) * N16;
-            assert(tmp > -0.5 && tmp < 65535.5);
-            summer[i][vi] = static_cast<unsigned short>(tmp + 0.5);
-        }
+        opampTables.add(&summer[i], size, idiv, idiv);
     }
 
     // The audio mixer operates at n ~ 8/5, and has 8 fundamentally different
@@ -195,17 +208,7 @@ FilterModelConfig8580::FilterModelConfig8580() :
     {
         const int idiv = (i == 0) ? 1 : i;
         const int size = (i == 0) ? 1 : i << 16;
-        const double n = i * 8.0 / 5.0;
-        opampModel.reset();
-        mixer[i] = new unsigned short[size];
-
-        for (int vi = 0; vi < size; vi++)
-        {
-            const double vin = vmin + vi / N16 / idiv; /* vmin .. vmax */
-            const double tmp = (opampModel.solve(n, vin) - vmin) * N16;
-            assert(tmp > -0.5 && tmp < 65535.5);
-            mixer[i][vi] = static_cast<unsigned short>(tmp + 0.5);
-        }
+        opampTables.add(&mixer[i], size, i * 8.0 / 5.0, idiv);
     }
 
     // 4 bit "resistor" ladders in the audio output gain
@@ -215,17 +218,7 @@ FilterModelConfig8580::FilterModelConfig8580() :
     for (int n8 = 0; n8 < 16; n8++)
     {
         const int size = 1 << 16;
-        const double n = n8 / 16.0;
-        opampModel.reset();
-        gain_vol[n8] = new unsigned short[size];
-
-        for (int vi = 0; vi < size; vi++)
-        {
-            const double vin = vmin + vi / N16; /* vmin .. vmax */
-            const double tmp = (opampModel.solve(n, vin) - vmin) * N16;
-            assert(tmp > -0.5 && tmp < 65535.5);
-            gain_vol[n8][vi] = static_cast<unsigned short>(tmp + 0.5);
-        }
+        opampTables.add(&gain_vol[n8], size, n8 / 16.0, 1);
     }
 
     // 4 bit "resistor" ladders in the bandpass resonance gain
@@ -236,37 +229,14 @@ FilterModelConfig8580::FilterModelConfig8580() :
     for (int n8 = 0; n8 < 16; n8++)
     {
         const int size = 1 << 16;
-        opampModel.reset();
-        gain_res[n8] = new unsigned short[size];
-
-        for (int vi = 0; vi < size; vi++)
-        {
-            const double vin = vmin + vi / N16; /* vmin .. vmax */
-            const double tmp = (opampModel.solve(resGain[n8], vin) - vmin) * N16;
-            assert(tmp > -0.5 && tmp < 65535.5);
-            gain_res[n8][vi] = static_cast<unsigned short>(tmp + 0.5);
-        }
+        opampTables.add(&gain_res[n8], size, resGain[n8], 1);
     }
+
+    opampTables.build(filterModelImage8580, filterModelImage8580Size);
 }
 
 FilterModelConfig8580::~FilterModelConfig8580()
-{
-    for (int i = 0; i < 5; i++)
-    {
-        delete [] summer[i];
-    }
-
-    for (int i = 0; i < 8; i++)
-    {
-        delete [] mixer[i];
-    }
-
-    for (int i = 0; i < 16; i++)
-    {
-        delete [] gain_vol[i];
-        delete [] gain_res[i];
-    }
-}
+{}
 
 std::unique_ptr<Integrator8580> FilterModelConfig8580::buildIntegrator()
 {
@@ -26,6 +26,7 @@
 #include <memory>
 
 #include "Spline.h"
+#include "FilterModelTables.h"
 
 #include "sidcxx11.h"
 
@@ -70,6 +71,9 @@ private:
     /// Fixed point scaling for 16 bit op-amp output.
     const double N16;
 
+    /// Builder of the op-amp lookup tables.
+    FilterModelTables opampTables;
+
     /// Lookup tables for gain and summer op-amps in output stage / filter.
     //@{
     unsigned short* mixer[8];
@@ -106,6 +110,11 @@ public:
 
     unsigned short** getMixer() { return mixer; }
 
+    /**
+     * Get the op-amp lookup tables, for baking them at build time.
+     */
+    const FilterModelTables& getOpAmpTables() const { return opampTables; }
+
     /**
      * Construct an integrator solver.
      *
@@ -0,0 +1,41 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "FilterModelTables.h"
+
+namespace reSIDfp
+{
+
+// Generated by mkfiltertables
+const unsigned char filterModelImage6581[] =
+{
+#include "FilterModelImage6581.bin"
+};
+
+const size_t filterModelImage6581Size = sizeof(filterModelImage6581);
+
+const unsigned char filterModelImage8580[] =
+{
+#include "FilterModelImage8580.bin"
+};
+
+const size_t filterModelImage8580Size = sizeof(filterModelImage8580);
+
+} // namespace reSIDfp
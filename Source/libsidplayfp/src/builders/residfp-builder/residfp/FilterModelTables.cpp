@@ -0,0 +1,240 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "FilterModelTables.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "TableCache.h"
+#include "parallel.h"
+
+#include "sidcxx11.h"
+
+namespace reSIDfp
+{
+
+/// Entries of each table checked against the solver,
+/// spread from the first to the last one.
+const unsigned int CHECK_ENTRIES = 64;
+
+/**
+ * Solve whole tables.
+ */
+class FilterModelTables::SolveTask
+{
+private:
+    const FilterModelTables &owner;
+
+    /// Table indices, largest first
+    std::vector<unsigned int> order;
+
+private:
+    /**
+     * Order table indices by decreasing size.
+     */
+    class Larger
+    {
+    private:
+        const std::vector<table_t> &tables;
+
+    public:
+        Larger(const std::vector<table_t> &tables) : tables(tables) {}
+
+        bool operator()(unsigned int a, unsigned int b) const
+        {
+            return tables[a].size > tables[b].size;
+        }
+    };
+
+public:
+    SolveTask(const FilterModelTables &owner) :
+        owner(owner)
+    {
+        for (unsigned int i = 0; i < owner.tables.size(); i++)
+            order.push_back(i);
+        std::stable_sort(order.begin(), order.end(), Larger(owner.tables));
+    }
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+        for (unsigned int i = begin; i < end; i++)
+        {
+            const table_t &table = owner.tables[order[i]];
+            owner.solve(table, *table.data, 0, table.size);
+        }
+    }
+};
+
+FilterModelTables::FilterModelTables(const Spline::Point opamp[], int opamplength, double Vddt, double vmin, double N16) :
+    opamp(opamp),
+    opamplength(opamplength),
+    Vddt(Vddt),
+    vmin(vmin),
+    N16(N16),
+    storage(nullptr),
+    mapped(false)
+{
+    fingerprint = TableCache::hash(opamp, opamplength * sizeof(Spline::Point));
+    fingerprint = TableCache::hash(&Vddt, sizeof(Vddt), fingerprint);
+    fingerprint = TableCache::hash(&vmin, sizeof(vmin), fingerprint);
+    fingerprint = TableCache::hash(&N16, sizeof(N16), fingerprint);
+}
+
+FilterModelTables::~FilterModelTables()
+{
+    detach();
+}
+
+void FilterModelTables::add(unsigned short **data, unsigned int size, double n, int idiv)
+{
+    const table_t table = { data, size, n, idiv };
+    tables.push_back(table);
+
+    fingerprint = TableCache::hash(&size, sizeof(size), fingerprint);
+    fingerprint = TableCache::hash(&n, sizeof(n), fingerprint);
+    fingerprint = TableCache::hash(&idiv, sizeof(idiv), fingerprint);
+}
+
+size_t FilterModelTables::storageSize() const
+{
+    size_t entries = 0;
+    for (std::vector<table_t>::const_iterator it = tables.begin(); it != tables.end(); ++it)
+    {
+        entries += it->size;
+    }
+    return entries * sizeof(unsigned short);
+}
+
+void FilterModelTables::attach(unsigned short *block, bool isMapped)
+{
+    storage = block;
+    mapped = isMapped;
+
+    for (std::vector<table_t>::const_iterator it = tables.begin(); it != tables.end(); ++it)
+    {
+        *it->data = block;
+        block += it->size;
+    }
+}
+
+void FilterModelTables::detach()
+{
+    if (mapped)
+        TableCache::release(storage, storageSize());
+    else
+        delete [] storage;
+
+    storage = nullptr;
+    mapped = false;
+}
+
+void FilterModelTables::solve(const table_t &table, unsigned short *out, unsigned int first, unsigned int count) const
+{
+    const OpAmp opampModel(opamp, opamplength, Vddt);
+    opampModel.reset();
+
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const unsigned int vi = first + i;
+        const double vin = vmin + vi / N16 / table.idiv; /* vmin .. vmax */
+        const double tmp = (opampModel.solve(table.n, vin) - vmin) * N16;
+        assert(tmp > -0.5 && tmp < 65535.5);
+        out[i] = static_cast<unsigned short>(tmp + 0.5);
+    }
+}
+
+bool FilterModelTables::build(const unsigned char *image, size_t length)
+{
+    detach();
+
+    const size_t size = storageSize();
+
+    // The tables are read only, so they can be shared with other processes
+    const void *cached = TableCache::load("filter", fingerprint, size);
+    if (cached != nullptr)
+    {
+        attach(static_cast<unsigned short*>(const_cast<void*>(cached)), true);
+        return true;
+    }
+
+    attach(new unsigned short[size / sizeof(unsigned short)], false);
+
+    const bool baked = decode(image, length) && check();
+
+    if (!baked)
+    {
+        parallelFor(SolveTask(*this), tables.size());
+    }
+
+    cached = TableCache::store("filter", fingerprint, storage, size);
+    if (cached != nullptr)
+    {
+        detach();
+        attach(static_cast<unsigned short*>(const_cast<void*>(cached)), true);
+    }
+
+    return baked;
+}
+
+bool FilterModelTables::check() const
+{
+    for (std::vector<table_t>::const_iterator it = tables.begin(); it != tables.end(); ++it)
+    {
+        // The solver converges to the same entry from any starting point,
+        // so the entries can be checked one by one
+        for (unsigned int i = 0; i < CHECK_ENTRIES; i++)
+        {
+            const unsigned int vi = (it->size - 1) * i / (CHECK_ENTRIES - 1);
+
+            unsigned short entry;
+            solve(*it, &entry, vi, 1);
+            if (entry != (*it->data)[vi])
+                return false;
+        }
+    }
+
+    return true;
+}
+
+void FilterModelTables::images(std::vector<TableImage::table_t> &images) const
+{
+    for (std::vector<table_t>::const_iterator it = tables.begin(); it != tables.end(); ++it)
+    {
+        const TableImage::table_t image = { *it->data, it->size };
+        images.push_back(image);
+    }
+}
+
+void FilterModelTables::encode(std::vector<unsigned char> &image) const
+{
+    std::vector<TableImage::table_t> images;
+    this->images(images);
+    TableImage::encode(images, fingerprint, image);
+}
+
+bool FilterModelTables::decode(const unsigned char *image, size_t length)
+{
+    std::vector<TableImage::table_t> images;
+    this->images(images);
+    return TableImage::decode(images, fingerprint, image, length);
+}
+
+} // namespace reSIDfp
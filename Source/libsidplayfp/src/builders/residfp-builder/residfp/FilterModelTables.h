@@ -0,0 +1,182 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FILTERMODELTABLES_H
+#define FILTERMODELTABLES_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+#include "OpAmp.h"
+#include "Spline.h"
+#include "TableImage.h"
+
+namespace reSIDfp
+{
+
+/**
+ * Op-amp lookup tables of a filter model.
+ *
+ * Solving the op-amp equation for every entry is what makes
+ * the filter model setup slow, so the tables are generated
+ * at build time by mkfiltertables and linked into the library
+ * as a compact TableImage.
+ *
+ * The image is used only if it was made for the same model
+ * parameters and entries spread over each table agree with
+ * the solver, otherwise the tables are solved at run time.
+ * This catches images baked on a host whose floating point
+ * gives different results, as for universal binaries.
+ *
+ * All tables live in a single block, which is shared through
+ * the TableCache when a cache directory is set.
+ * Tables are independent of each other, so they are solved
+ * and decoded in parallel.
+ */
+class FilterModelTables
+{
+public:
+    /// An op-amp table, the output for inputs from vmin to vmax.
+    typedef struct
+    {
+        unsigned short **data;  ///< where to store the table address
+        unsigned int size;
+        double n;       ///< ratio of input/output loading
+        int idiv;       ///< number of input "resistors"
+    } table_t;
+
+private:
+    class SolveTask;
+
+private:
+    /// Op-amp model, each table is solved by its own OpAmp.
+    //@{
+    const Spline::Point *const opamp;
+    const int opamplength;
+    const double Vddt;
+    //@}
+
+    const double vmin;
+    const double N16;
+
+    std::vector<table_t> tables;
+
+    /// Hash of the model parameters and table layout.
+    uint32_t fingerprint;
+
+    /// Storage of all the tables.
+    unsigned short *storage;
+
+    /// Is the storage a mapped cache file?
+    bool mapped;
+
+private:
+    /**
+     * Point the tables into a storage block.
+     *
+     * @param block the storage
+     * @param isMapped true if block is a mapped cache file
+     */
+    void attach(unsigned short *block, bool isMapped);
+
+    /**
+     * Free the storage.
+     */
+    void detach();
+
+    /**
+     * Get the size of the storage in bytes.
+     */
+    size_t storageSize() const;
+
+    /**
+     * Solve a range of entries of a table.
+     *
+     * @param table the table
+     * @param out where to store the entries
+     * @param first the first entry
+     * @param count how many entries
+     */
+    void solve(const table_t &table, unsigned short *out, unsigned int first, unsigned int count) const;
+
+    /**
+     * List the tables for the image.
+     */
+    void images(std::vector<TableImage::table_t> &images) const;
+
+    bool decode(const unsigned char *image, size_t length);
+
+    /**
+     * Check the decoded tables against the solver.
+     */
+    bool check() const;
+
+public:
+    /**
+     * @param opamp opamp mapping table as pairs of points (in -> out), must outlive the object
+     * @param opamplength length of the opamp array
+     * @param Vddt transistor dt parameter (in volts)
+     * @param vmin lowest voltage
+     * @param N16 fixed point scaling for 16 bit op-amp output
+     */
+    FilterModelTables(const Spline::Point opamp[], int opamplength, double Vddt, double vmin, double N16);
+    ~FilterModelTables();
+
+    /**
+     * Add a table.
+     * The table is allocated by build().
+     *
+     * @param data where to store the table address
+     * @param size number of entries
+     * @param n the ratio of input/output loading
+     * @param idiv number of input "resistors"
+     */
+    void add(unsigned short **data, unsigned int size, double n, int idiv);
+
+    /**
+     * Map the tables from the cache, or fill them from
+     * a baked image, or solve them if it can't be used.
+     *
+     * @param image the image
+     * @param length the image size in bytes
+     * @return false if the tables were solved
+     */
+    bool build(const unsigned char *image, size_t length);
+
+    /**
+     * Encode the tables into an image.
+     *
+     * @param image the output
+     */
+    void encode(std::vector<unsigned char> &image) const;
+};
+
+/// Images baked at build time, unusable if they could not be generated.
+//@{
+extern const unsigned char filterModelImage6581[];
+extern const size_t filterModelImage6581Size;
+extern const unsigned char filterModelImage8580[];
+extern const size_t filterModelImage8580Size;
+//@}
+
+} // namespace reSIDfp
+
+#endif
@@ -204,6 +204,10 @@ public:
     void setVw(unsigned short Vw) { Vddt_Vw_2 = ((Vddt - Vw) * (Vddt - Vw)) >> 1; }
 
     int solve(int vi) const;
+
+    int getVx() const { return vx; }
+
+    int getVc() const { return vc; }
 };
 
 } // namespace reSIDfp
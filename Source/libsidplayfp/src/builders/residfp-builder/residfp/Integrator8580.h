@@ -105,6 +105,10 @@ public:
     }
 
     int solve(int vi) const;
+
+    int getVx() const { return vx; }
+
+    int getVc() const { return vc; }
 };
 
 } // namespace reSIDfp
@@ -26,6 +26,7 @@
 #include <memory>
 
 #include "siddefs-fp.h"
+#include "Voice.h"
 
 #include "sidcxx11.h"
 
@@ -37,7 +38,6 @@ class Filter6581;
 class Filter8580;
 class ExternalFilter;
 class Potentiometer;
-class Voice;
 class Resampler;
 
 /**
@@ -59,6 +59,10 @@ public:
  */
 class SID
 {
+private:
+    /// Number of cycles resampled at once by clock().
+    static const unsigned int OUTPUT_BLOCK = 256;
+
 private:
     /// Currently active filter
     Filter* filter;
@@ -84,8 +88,8 @@ private:
     /// Paddle Y register support
     std::unique_ptr<Potentiometer> const potY;
 
-    /// SID voices
-    std::unique_ptr<Voice> voice[3];
+    /// SID voices, kept inline so that their state is contiguous
+    Voice voice[3];
 
     /// Time to live for the last written value
     int busValueTtl;
@@ -114,11 +118,46 @@ private:
     void ageBusValue(unsigned int n);
 
     /**
-     * Get output sample.
+     * Clock the voices for one cycle and get their output.
+     *
+     * @param waveActive the waveform generators to clock, the others are silent
+     * @param envelopeActive the envelope generators to clock
+     * @param voiceOutput the output of each voice for the block
+     * @param i the cycle in the block
+     */
+    void clockVoices(const bool waveActive[3], const bool envelopeActive[3],
+            int voiceOutput[3][OUTPUT_BLOCK], unsigned int i);
+
+    /**
+     * Clock the filters with all the voices silent. If they have
+     * settled their output stays the same and the following cycles
+     * are filled in without clocking them.
+     *
+     * @param output the output samples
+     * @param cycles the number of cycles to fill at most
+     * @return the number of cycles done
+     */
+    unsigned int clockSettled(int* output, unsigned int cycles);
+
+    /**
+     * Store a resampled value in a 16 bit output buffer, clipped.
+     */
+    void store(short* buf, int value) const;
+
+    /**
+     * Store a resampled value in a high resolution output buffer.
+     */
+    void store(int* buf, int value) const;
+
+    /**
+     * Clock SID forward, common to both output formats.
      *
-     * @return the output sample
+     * @param cycles c64 clocks to clock
+     * @param buf audio output buffer
+     * @return number of samples produced
      */
-    int output() const;
+    template<typename T>
+    int clockOutput(unsigned int cycles, T* buf);
 
     /**
      * Calculate the numebr of cycles according to current parameters
@@ -217,13 +256,24 @@ public:
      * is limited to slightly below 20kHz.
      * This constraint ensures that the FIR table is not overfilled.
      *
+     * For resampling the cheapest sinc filter, single or two pass,
+     * is chosen for the output rate, passband and precision.
+     * The precision sets the stopband attenuation, about 6 dB per bit.
+     *
+     * In high resolution mode the resampler keeps the samples unclipped,
+     * so that the high resolution clock() has the full range of the
+     * chip output, at about twice the resampling cost.
+     *
      * @param clockFrequency System clock frequency at Hz
      * @param method sampling method to use
      * @param samplingFrequency Desired output sampling rate
      * @param highestAccurateFrequency
+     * @param precision filter precision in bits, between 8 and 16
+     * @param highResolution keep the samples unclipped until the output
      * @throw SIDError
      */
-    void setSamplingParameters(double clockFrequency, SamplingMethod method, double samplingFrequency, double highestAccurateFrequency);
+    void setSamplingParameters(double clockFrequency, SamplingMethod method, double samplingFrequency, double highestAccurateFrequency, int precision = 16,
+            bool highResolution = false);
 
     /**
      * Clock SID forward using chosen output sampling algorithm.
@@ -234,6 +284,18 @@ public:
      */
     int clock(unsigned int cycles, short* buf);
 
+    /**
+     * Clock SID forward using chosen output sampling algorithm,
+     * with high resolution output.
+     * The samples have the scale of the 16 bit ones but are not clipped,
+     * so they can go beyond the 16 bit range, up to about +/-65536.
+     *
+     * @param cycles c64 clocks to clock
+     * @param buf audio output buffer
+     * @return number of samples produced
+     */
+    int clock(unsigned int cycles, int* buf);
+
     /**
      * Clock SID forward with no audio production.
      *
@@ -273,10 +335,10 @@ public:
 #if RESID_INLINING || defined(SID_CPP)
 
 #include <algorithm>
+#include <cstring>
 
 #include "Filter.h"
 #include "ExternalFilter.h"
-#include "Voice.h"
 #include "resample/Resampler.h"
 
 namespace reSIDfp
@@ -298,18 +360,64 @@ void SID::ageBusValue(unsigned int n)
 }
 
 RESID_INLINE
-int SID::output() const
+void SID::clockVoices(const bool waveActive[3], const bool envelopeActive[3],
+        int voiceOutput[3][OUTPUT_BLOCK], unsigned int i)
 {
-    const int v1 = voice[0]->output(voice[2]->wave());
-    const int v2 = voice[1]->output(voice[0]->wave());
-    const int v3 = voice[2]->output(voice[1]->wave());
+    // clock waveform generators
+    if (waveActive[0])
+        voice[0].wave()->clock();
+    if (waveActive[1])
+        voice[1].wave()->clock();
+    if (waveActive[2])
+        voice[2].wave()->clock();
+
+    // clock envelope generators
+    if (envelopeActive[0])
+        voice[0].envelope()->clock();
+    if (envelopeActive[1])
+        voice[1].envelope()->clock();
+    if (envelopeActive[2])
+        voice[2].envelope()->clock();
+
+    voiceOutput[0][i] = waveActive[0] ? voice[0].output(voice[2].wave()) : 0;
+    voiceOutput[1][i] = waveActive[1] ? voice[1].output(voice[0].wave()) : 0;
+    voiceOutput[2][i] = waveActive[2] ? voice[2].output(voice[1].wave()) : 0;
+}
+
+RESID_INLINE
+unsigned int SID::clockSettled(int* output, unsigned int cycles)
+{
+    Filter::state_t before;
+    filter->getState(before);
+
+    const unsigned short filterOutput = filter->clock(0, 0, 0);
+    output[0] = externalFilter->clock(filterOutput);
 
-    return externalFilter->clock(filter->clock(v1, v2, v3));
+    Filter::state_t after;
+    filter->getState(after);
+
+    if (memcmp(&before, &after, sizeof(Filter::state_t)) != 0
+        || !externalFilter->isSettled(filterOutput))
+        return 1;
+
+    std::fill(output + 1, output + cycles, output[0]);
+    return cycles;
 }
 
+RESID_INLINE
+void SID::store(short* buf, int value) const
+{
+    *buf = resampler->softClip(value);
+}
 
 RESID_INLINE
-int SID::clock(unsigned int cycles, short* buf)
+void SID::store(int* buf, int value) const
+{
+    *buf = value;
+}
+
+template<typename T>
+int SID::clockOutput(unsigned int cycles, T* buf)
 {
     ageBusValue(cycles);
     int s = 0;
@@ -320,26 +428,101 @@ int SID::clock(unsigned int cycles, short* buf)
 
         if (likely(delta_t > 0))
         {
-            for (unsigned int i = 0; i < delta_t; i++)
+            cycles -= delta_t;
+            nextVoiceSync -= delta_t;
+
+            int cycleOutput[OUTPUT_BLOCK];
+            int voiceOutput[3][OUTPUT_BLOCK];
+            unsigned short filterOutput[OUTPUT_BLOCK];
+
+            while (delta_t != 0)
             {
-                // clock waveform generators
-                voice[0]->wave()->clock();
-                voice[1]->wave()->clock();
-                voice[2]->wave()->clock();
+                const unsigned int block = delta_t < OUTPUT_BLOCK ? delta_t : OUTPUT_BLOCK;
+
+                // Envelopes which can't change within the block are clocked at once,
+                // their output stays the same.
+                bool envelopeActive[3];
+                for (unsigned int v = 0; v < 3; v++)
+                {
+                    EnvelopeGenerator* const envelope = voice[v].envelope();
+                    envelopeActive[v] = envelope->idleCycles() < block;
+                    if (!envelopeActive[v])
+                        envelope->clock(block);
+                }
 
-                // clock envelope generators
-                voice[0]->envelope()->clock();
-                voice[1]->envelope()->clock();
-                voice[2]->envelope()->clock();
+                // Silent voices whose accumulator is not read by a ring modulated
+                // voice are advanced at once, and clocked with output only
+                // in the last cycles, which refresh the output latches.
+                static const bool allActive[3] = { true, true, true };
+                bool waveActive[3] = { true, true, true };
+                unsigned int tail = block;
+                if (block > 2)
+                {
+                    for (unsigned int v = 0; v < 3; v++)
+                    {
+                        waveActive[v] = envelopeActive[v]
+                            || voice[v].envelope()->output() != 0.f
+                            || !voice[v].wave()->canAdvance();
+                    }
+
+                    // Voice v reads the accumulator of voice v-1, up to two in a chain
+                    for (unsigned int pass = 0; pass < 2; pass++)
+                    {
+                        for (unsigned int v = 0; v < 3; v++)
+                        {
+                            if (waveActive[v] && voice[v].wave()->isRingModulated())
+                                waveActive[(v + 2) % 3] = true;
+                        }
+                    }
+
+                    for (unsigned int v = 0; v < 3; v++)
+                    {
+                        if (!waveActive[v])
+                        {
+                            voice[v].wave()->advance(block - 2);
+                            tail = block - 2;
+                        }
+                    }
+                }
 
-                if (unlikely(resampler->input(output())))
+                unsigned int first = 0;
+
+                // A silent chip settles to a constant output, which needs
+                // no clocking until a voice starts or a register changes.
+                if (!waveActive[0] && !waveActive[1] && !waveActive[2])
                 {
-                    buf[s++] = resampler->getOutput();
+                    first = clockSettled(cycleOutput, tail);
                 }
-            }
 
-            cycles -= delta_t;
-            nextVoiceSync -= delta_t;
+                unsigned int i = first;
+                for (; i < tail; i++)
+                {
+                    clockVoices(waveActive, envelopeActive, voiceOutput, i);
+                }
+                for (; i < block; i++)
+                {
+                    clockVoices(allActive, envelopeActive, voiceOutput, i);
+                }
+
+                // Filter the whole block at once
+                filter->clock(voiceOutput[0] + first, voiceOutput[1] + first, voiceOutput[2] + first,
+                    filterOutput + first, block - first);
+
+                for (i = first; i < block; i++)
+                {
+                    cycleOutput[i] = externalFilter->clock(filterOutput[i]);
+                }
+
+                // Resample the whole block at once
+                const unsigned int n = resampler->inputBlock(cycleOutput, block, cycleOutput);
+
+                for (unsigned int i = 0; i < n; i++)
+                {
+                    store(buf + s++, cycleOutput[i]);
+                }
+
+                delta_t -= block;
+            }
         }
 
         if (unlikely(nextVoiceSync == 0))
@@ -351,6 +534,18 @@ int SID::clock(unsigned int cycles, short* buf)
     return s;
 }
 
+RESID_INLINE
+int SID::clock(unsigned int cycles, short* buf)
+{
+    return clockOutput(cycles, buf);
+}
+
+RESID_INLINE
+int SID::clock(unsigned int cycles, int* buf)
+{
+    return clockOutput(cycles, buf);
+}
+
 } // namespace reSIDfp
 
 #endif
@@ -0,0 +1,224 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "TableCache.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "siddefs-fp.h"
+
+#include "sidcxx11.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+#if defined(HAVE_UNISTD_H) && !defined(_WIN32)
+#  define HAVE_MMAP
+#  include <fcntl.h>
+#  include <unistd.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
+
+namespace reSIDfp
+{
+
+/// Cache file identifier, bump the last byte on format changes.
+const uint32_t CACHE_MAGIC = 0x52544302; // "RTC" 2
+
+/**
+ * Cache file header, written in native byte order
+ * so files from a different architecture are rejected.
+ * Its size keeps the table aligned for vector loads.
+ */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t key;
+    uint32_t size;
+    uint32_t headerSize;
+    /// Checksum of the table contents
+    uint64_t checksum;
+    /// Version of the library which computed the table
+    char version[40];
+} header_t;
+
+/// The cache directory, empty if disabled.
+static std::string directory;
+
+void TableCache::setDirectory(const char *path)
+{
+    directory = (path != nullptr) ? path : "";
+}
+
+uint32_t TableCache::hash(const void *data, size_t size, uint32_t key)
+{
+    // FNV-1a
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++)
+    {
+        key ^= p[i];
+        key *= 16777619u;
+    }
+    return key;
+}
+
+#ifdef HAVE_MMAP
+
+/**
+ * 64 bit FNV-1a of the table contents, so that a file
+ * which was damaged after being written is not used.
+ */
+static uint64_t checksum(const void *data, size_t size)
+{
+    const unsigned char *p = static_cast<const unsigned char*>(data);
+    uint64_t sum = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        sum ^= p[i];
+        sum *= 1099511628211ull;
+    }
+    return sum;
+}
+
+static bool sameVersion(const char *version)
+{
+    return strncmp(version, residfp_version_string, sizeof(header_t().version)) == 0;
+}
+
+static std::string fileName(const char *name, uint32_t key)
+{
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%08x", key);
+    return directory + "/residfp-" + residfp_version_string + "-" + name + "-" + buf + ".tbl";
+}
+
+const void *TableCache::load(const char *name, uint32_t key, size_t size)
+{
+    if (directory.empty())
+        return nullptr;
+
+    const std::string path = fileName(name, key);
+
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat st;
+    const size_t length = sizeof(header_t) + size;
+    void *map = MAP_FAILED;
+    if ((fstat(fd, &st) == 0) && (static_cast<size_t>(st.st_size) == length))
+    {
+        map = mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+
+    if (map == MAP_FAILED)
+        return nullptr;
+
+    const header_t *header = static_cast<const header_t*>(map);
+    if ((header->magic != CACHE_MAGIC)
+        || (header->key != key)
+        || (header->size != size)
+        || (header->headerSize != sizeof(header_t))
+        || !sameVersion(header->version)
+        || (header->checksum != checksum(header + 1, size)))
+    {
+        munmap(map, length);
+        return nullptr;
+    }
+
+    return header + 1;
+}
+
+const void *TableCache::store(const char *name, uint32_t key, const void *data, size_t size)
+{
+    if (directory.empty()
+        || (size > 0xffffffffu - sizeof(header_t))
+        || (strlen(residfp_version_string) >= sizeof(header_t().version)))
+        return nullptr;
+
+    const std::string path = fileName(name, key);
+
+    // Unique temporary name in the same directory, for an atomic rename
+    std::string tmp = path + ".XXXXXX";
+    const int fd = mkstemp(&tmp[0]);
+    if (fd < 0)
+        return nullptr;
+
+    header_t header;
+    memset(&header, 0, sizeof(header));
+    header.magic = CACHE_MAGIC;
+    header.key = key;
+    header.size = static_cast<uint32_t>(size);
+    header.headerSize = sizeof(header_t);
+    header.checksum = checksum(data, size);
+    strcpy(header.version, residfp_version_string);
+
+    bool ok = write(fd, &header, sizeof(header)) == static_cast<ssize_t>(sizeof(header));
+
+    const char *p = static_cast<const char*>(data);
+    size_t left = size;
+    while (ok && (left > 0))
+    {
+        const ssize_t n = write(fd, p, left);
+        ok = n > 0;
+        if (ok)
+        {
+            p += n;
+            left -= n;
+        }
+    }
+
+    // Make the file readable by other users of the directory
+    ok = ok && (fchmod(fd, 0644) == 0);
+    ok = (close(fd) == 0) && ok;
+    ok = ok && (rename(tmp.c_str(), path.c_str()) == 0);
+
+    if (!ok)
+    {
+        unlink(tmp.c_str());
+        return nullptr;
+    }
+
+    return load(name, key, size);
+}
+
+void TableCache::release(const void *table, size_t size)
+{
+    const header_t *header = static_cast<const header_t*>(table) - 1;
+    munmap(const_cast<header_t*>(header), sizeof(header_t) + size);
+}
+
+#else
+
+const void *TableCache::load(const char*, uint32_t, size_t) { return nullptr; }
+
+const void *TableCache::store(const char*, uint32_t, const void*, size_t) { return nullptr; }
+
+void TableCache::release(const void*, size_t) {}
+
+#endif
+
+} // namespace reSIDfp
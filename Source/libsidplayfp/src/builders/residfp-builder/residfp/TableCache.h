@@ -0,0 +1,108 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef TABLECACHE_H
+#define TABLECACHE_H
+
+#include <stdint.h>
+#include <cstddef>
+
+namespace reSIDfp
+{
+
+/**
+ * On-disk cache of lookup tables.
+ *
+ * Tables are written once to a cache directory and then mapped
+ * read-only, so processes using the same tables share them
+ * through the page cache instead of each computing a private copy.
+ *
+ * Each table is a file named after the library version, the table
+ * and a key which identifies the parameters it was computed from.
+ * Files are written to a temporary name and then renamed,
+ * so a reader sees either a complete table or none.
+ * A file is never written again once in place: a new table replaces
+ * it by rename, which leaves the file mapped by others untouched.
+ * A header records the library version, the table size and
+ * a checksum of the contents, all checked before a table is used.
+ *
+ * The cache is disabled unless a directory is set,
+ * and on systems without mmap.
+ */
+class TableCache
+{
+public:
+    /**
+     * Set the cache directory.
+     * Must be called before the tables are first built.
+     *
+     * The tables stay mapped from their files while in use.
+     * Files may be deleted at any time, but truncating or rewriting
+     * one in place makes the processes using it crash with SIGBUS.
+     *
+     * @param path an existing directory, null or empty to disable the cache
+     */
+    static void setDirectory(const char *path);
+
+    /**
+     * Compute a table key.
+     *
+     * @param data the parameters of the table
+     * @param size size of the parameters in bytes
+     * @param key the key to extend
+     * @return the key
+     */
+    static uint32_t hash(const void *data, size_t size, uint32_t key = 2166136261u);
+
+    /**
+     * Map a cached table.
+     *
+     * @param name the table name
+     * @param key the table key
+     * @param size the table size in bytes
+     * @return the table, or nullptr if not cached
+     */
+    static const void *load(const char *name, uint32_t key, size_t size);
+
+    /**
+     * Add a table to the cache and map it.
+     * An existing file for the table is replaced, not overwritten.
+     *
+     * @param name the table name
+     * @param key the table key
+     * @param data the table contents
+     * @param size the table size in bytes
+     * @return the mapped table, or nullptr if it could not be cached
+     */
+    static const void *store(const char *name, uint32_t key, const void *data, size_t size);
+
+    /**
+     * Unmap a table returned by load() or store().
+     * Tables not released stay mapped until the process exits.
+     *
+     * @param table the table
+     * @param size the table size in bytes
+     */
+    static void release(const void *table, size_t size);
+};
+
+} // namespace reSIDfp
+
+#endif
@@ -0,0 +1,254 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "TableImage.h"
+
+#include "parallel.h"
+
+namespace reSIDfp
+{
+
+/// Image format identifier, bump the last byte on format changes.
+const uint32_t IMAGE_MAGIC = 0x52465401; // "RFT" 1
+
+/// Second order difference codes.
+enum
+{
+    CODE_ZERO = 0,
+    CODE_PLUS = 1,
+    CODE_MINUS = 2,
+    CODE_LITERAL = 3
+};
+
+/// Change of the difference for each code but CODE_LITERAL.
+const int step[3] = { 0, 1, -1 };
+
+/**
+ * Fletcher style checksum of a table, cheap enough to be
+ * computed while decoding.
+ */
+class Checksum
+{
+private:
+    uint32_t a, b;
+
+public:
+    Checksum() : a(0), b(0) {}
+
+    void add(unsigned int value) { a += value; b += a; }
+
+    /**
+     * Append the checksum of the following values.
+     *
+     * @param next the checksum of the values
+     * @param count the number of values
+     */
+    void append(const Checksum &next, uint32_t count)
+    {
+        b += next.b + count * a;
+        a += next.a;
+    }
+
+    uint32_t get() const { return a ^ (b << 16 | b >> 16); }
+};
+
+static void put32(std::vector<unsigned char> &image, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        image.push_back(static_cast<unsigned char>(value >> (i * 8)));
+}
+
+static uint32_t get32(const unsigned char *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+/**
+ * Where a table is in the image.
+ */
+typedef struct
+{
+    const unsigned char *codes;
+    const unsigned char *literals;
+    const unsigned char *end;
+} source_t;
+
+/**
+ * Decode whole tables, keeping the checksum of each.
+ */
+class TableImage::DecodeTask
+{
+private:
+    const std::vector<table_t> &tables;
+    const std::vector<source_t> &sources;
+    std::vector<Checksum> &checksums;
+    std::vector<unsigned char> &valid;
+
+public:
+    DecodeTask(const std::vector<table_t> &tables, const std::vector<source_t> &sources,
+            std::vector<Checksum> &checksums, std::vector<unsigned char> &valid) :
+        tables(tables),
+        sources(sources),
+        checksums(checksums),
+        valid(valid) {}
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+        for (unsigned int t = begin; t < end; t++)
+        {
+            valid[t] = decode(tables[t], sources[t], checksums[t]);
+        }
+    }
+
+    static bool decode(const table_t &table, const source_t &source, Checksum &contents)
+    {
+        const unsigned char *codes = source.codes;
+        const unsigned char *literals = source.literals;
+        unsigned short *data = table.data;
+
+        int prev = 0;
+        int delta = 0;
+        for (unsigned int i = 0; i < table.size; i++)
+        {
+            const unsigned int code = (codes[i / 4] >> ((i % 4) * 2)) & 3;
+            if (code == CODE_LITERAL)
+            {
+                if (literals == source.end)
+                    return false;
+                delta = (literals[0] | (literals[1] << 8)) - prev;
+                literals += 2;
+            }
+            else
+            {
+                // the differences are random, avoid branching on them
+                delta += step[code];
+            }
+            prev += delta;
+            data[i] = static_cast<unsigned short>(prev);
+            contents.add(data[i]);
+        }
+
+        return true;
+    }
+};
+
+/*
+ * Image layout, all values are 32 bit little endian:
+ *
+ * - magic
+ * - fingerprint
+ * - number of tables
+ * - for each table the number of entries and of literals
+ * - checksum of the table contents
+ * - for each table the codes, four per byte starting
+ *   from the low bits, followed by the 16 bit literals
+ */
+void TableImage::encode(const std::vector<table_t> &tables, uint32_t fingerprint, std::vector<unsigned char> &image)
+{
+    image.clear();
+    put32(image, IMAGE_MAGIC);
+    put32(image, fingerprint);
+    put32(image, tables.size());
+
+    std::vector<unsigned char> body;
+    Checksum contents;
+
+    for (std::vector<table_t>::const_iterator it = tables.begin(); it != tables.end(); ++it)
+    {
+        std::vector<unsigned char> codes((it->size + 3) / 4, 0);
+        std::vector<unsigned char> literals;
+
+        int prev = 0;
+        int delta = 0;
+        for (unsigned int i = 0; i < it->size; i++)
+        {
+            const int value = it->data[i];
+            unsigned int code;
+            switch ((value - prev) - delta)
+            {
+            case 0:  code = CODE_ZERO; break;
+            case 1:  code = CODE_PLUS; delta++; break;
+            case -1: code = CODE_MINUS; delta--; break;
+            default:
+                code = CODE_LITERAL;
+                delta = value - prev;
+                literals.push_back(static_cast<unsigned char>(value));
+                literals.push_back(static_cast<unsigned char>(value >> 8));
+                break;
+            }
+            codes[i / 4] |= code << ((i % 4) * 2);
+            prev = value;
+            contents.add(value);
+        }
+
+        put32(image, it->size);
+        put32(image, literals.size() / 2);
+        body.insert(body.end(), codes.begin(), codes.end());
+        body.insert(body.end(), literals.begin(), literals.end());
+    }
+
+    put32(image, contents.get());
+    image.insert(image.end(), body.begin(), body.end());
+}
+
+bool TableImage::decode(const std::vector<table_t> &tables, uint32_t fingerprint, const unsigned char *image, size_t length)
+{
+    const size_t header = 4 * (4 + 2 * tables.size());
+    if (length < header
+        || get32(image) != IMAGE_MAGIC
+        || get32(image + 4) != fingerprint
+        || get32(image + 8) != tables.size())
+        return false;
+
+    // Locate the tables
+    std::vector<source_t> sources(tables.size());
+    const unsigned char *sizes = image + 12;
+    const unsigned char *p = image + header;
+    const unsigned char * const end = image + length;
+
+    for (unsigned int t = 0; t < tables.size(); t++, sizes += 8)
+    {
+        const uint32_t literalCount = get32(sizes + 4);
+        sources[t].codes = p;
+        sources[t].literals = p + (tables[t].size + 3) / 4;
+        p = sources[t].literals + literalCount * 2;
+        sources[t].end = p;
+
+        if (get32(sizes) != tables[t].size || p > end)
+            return false;
+    }
+
+    std::vector<Checksum> checksums(tables.size());
+    std::vector<unsigned char> valid(tables.size());
+
+    parallelFor(DecodeTask(tables, sources, checksums, valid), tables.size());
+
+    Checksum contents;
+    for (unsigned int t = 0; t < tables.size(); t++)
+    {
+        if (!valid[t])
+            return false;
+        contents.append(checksums[t], tables[t].size);
+    }
+
+    return contents.get() == get32(image + header - 4);
+}
+
+} // namespace reSIDfp
@@ -0,0 +1,80 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef TABLEIMAGE_H
+#define TABLEIMAGE_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+namespace reSIDfp
+{
+
+/**
+ * Compact image of smooth lookup tables, to be baked
+ * into the library at build time.
+ *
+ * Each table is kept as its second order differences,
+ * which for the op-amp tables are almost always -1, 0 or +1,
+ * packed in two bits each with escapes to literal values.
+ *
+ * The image carries a fingerprint of whatever the tables
+ * were computed from and a checksum of their contents.
+ */
+class TableImage
+{
+public:
+    /// A table to encode or to decode into.
+    typedef struct
+    {
+        unsigned short *data;
+        unsigned int size;
+    } table_t;
+
+private:
+    class DecodeTask;
+
+public:
+    /**
+     * Encode tables into an image.
+     *
+     * @param tables the tables
+     * @param fingerprint hash of the table parameters and layout
+     * @param image the output
+     */
+    static void encode(const std::vector<table_t> &tables, uint32_t fingerprint, std::vector<unsigned char> &image);
+
+    /**
+     * Decode an image into tables.
+     * The tables are garbage if the image is unusable.
+     *
+     * @param tables the tables, with the expected sizes
+     * @param fingerprint hash of the table parameters and layout
+     * @param image the image
+     * @param length the image size in bytes
+     * @return false if the image is not for these tables or is corrupt
+     */
+    static bool decode(const std::vector<table_t> &tables, uint32_t fingerprint, const unsigned char *image, size_t length);
+};
+
+} // namespace reSIDfp
+
+#endif
@@ -23,8 +23,6 @@
 #ifndef VOICE_H
 #define VOICE_H
 
-#include <memory>
-
 #include "siddefs-fp.h"
 #include "WaveformGenerator.h"
 #include "EnvelopeGenerator.h"
@@ -40,9 +38,9 @@ namespace reSIDfp
 class Voice
 {
 private:
-    std::unique_ptr<WaveformGenerator> const waveformGenerator;
+    WaveformGenerator waveformGenerator;
 
-    std::unique_ptr<EnvelopeGenerator> const envelopeGenerator;
+    EnvelopeGenerator envelopeGenerator;
 
 public:
     /**
@@ -60,21 +58,16 @@ public:
      * @return waveformgenerator output
      */
     RESID_INLINE
-    int output(const WaveformGenerator* ringModulator) const
+    int output(const WaveformGenerator* ringModulator)
     {
-        return static_cast<int>(waveformGenerator->output(ringModulator) * envelopeGenerator->output());
+        return static_cast<int>(waveformGenerator.output(ringModulator) * envelopeGenerator.output());
     }
 
-    /**
-     * Constructor.
-     */
-    Voice() :
-        waveformGenerator(new WaveformGenerator()),
-        envelopeGenerator(new EnvelopeGenerator()) {}
+    WaveformGenerator* wave() { return &waveformGenerator; }
 
-    WaveformGenerator* wave() const { return waveformGenerator.get(); }
+    const WaveformGenerator* wave() const { return &waveformGenerator; }
 
-    EnvelopeGenerator* envelope() const { return envelopeGenerator.get(); }
+    EnvelopeGenerator* envelope() { return &envelopeGenerator; }
 
     /**
      * Write control register.
@@ -83,8 +76,8 @@ public:
      */
     void writeCONTROL_REG(unsigned char control)
     {
-        waveformGenerator->writeCONTROL_REG(control);
-        envelopeGenerator->writeCONTROL_REG(control);
+        waveformGenerator.writeCONTROL_REG(control);
+        envelopeGenerator.writeCONTROL_REG(control);
     }
 
     /**
@@ -92,8 +85,8 @@ public:
      */
     void reset()
     {
-        waveformGenerator->reset();
-        envelopeGenerator->reset();
+        waveformGenerator.reset();
+        envelopeGenerator.reset();
     }
 };
 
@@ -21,6 +21,9 @@
 
 #include "WaveformCalculator.h"
 
+#include "TableCache.h"
+#include "parallel.h"
+
 #include <cmath>
 
 namespace reSIDfp
@@ -59,14 +62,65 @@ const CombinedWaveformConfig config[2][4] =
     },
 };
 
+/**
+ * Bit interconnection weights of a combined waveform,
+ * they only depend on the model parameters.
+ */
+typedef struct
+{
+    /// Weight of a bit at a distance of i - 12 bits.
+    float distance[12 * 2 + 1];
+
+    /// Sum of the weights seen by each bit.
+    float norm[12];
+
+    /// Sum of the weights seen by each bit, including the pulse line.
+    float normPulse[12];
+} CombinedWaveformWeights;
+
+/**
+ * Compute the interconnection weights.
+ *
+ * @param config model parameters matrix
+ * @param weights the weights
+ */
+void calculateWeights(const CombinedWaveformConfig& config, CombinedWaveformWeights& weights)
+{
+    float* distancetable = weights.distance;
+    distancetable[12] = 1.f;
+    for (int i = 12; i > 0; i--)
+    {
+        distancetable[12-i] = 1.0f / pow(config.distance1, i);
+        distancetable[12+i] = 1.0f / pow(config.distance2, i);
+    }
+
+    for (int i = 0; i < 12; i++)
+    {
+        float n = 0.f;
+
+        for (int j = 0; j < 12; j++)
+        {
+            n += distancetable[i - j + 12];
+        }
+
+        weights.norm[i] = n;
+
+        // pulse control bit
+        n += distancetable[i - 12 + 12];
+
+        weights.normPulse[i] = n;
+    }
+}
+
 /**
  * Generate bitstate based on emulation of combined waves.
  *
  * @param config model parameters matrix
+ * @param weights the interconnection weights for config
  * @param waveform the waveform to emulate, 1 .. 7
  * @param accumulator the high bits of the accumulator value
  */
-short calculateCombinedWaveform(const CombinedWaveformConfig& config, int waveform, int accumulator)
+short calculateCombinedWaveform(const CombinedWaveformConfig& config, const CombinedWaveformWeights& weights, int waveform, int accumulator)
 {
     float o[12];
 
@@ -118,36 +172,26 @@ short calculateCombinedWaveform(const CombinedWaveformConfig& config, int wavefo
     // ST, P* waveforms
     if (waveform == 3 || waveform > 4)
     {
-        float distancetable[12 * 2 + 1];
-        distancetable[12] = 1.f;
-        for (int i = 12; i > 0; i--)
-        {
-            distancetable[12-i] = 1.0f / pow(config.distance1, i);
-            distancetable[12+i] = 1.0f / pow(config.distance2, i);
-        }
+        const float* distancetable = weights.distance;
 
         float tmp[12];
 
         for (int i = 0; i < 12; i++)
         {
             float avg = 0.f;
-            float n = 0.f;
 
             for (int j = 0; j < 12; j++)
             {
-                const float weight = distancetable[i - j + 12];
-                avg += o[j] * weight;
-                n += weight;
+                avg += o[j] * distancetable[i - j + 12];
             }
 
             // pulse control bit
             if (waveform > 4)
             {
-                const float weight = distancetable[i - 12 + 12];
-                avg += config.pulsestrength * weight;
-                n += weight;
+                avg += config.pulsestrength * distancetable[i - 12 + 12];
             }
 
+            const float n = (waveform > 4) ? weights.normPulse[i] : weights.norm[i];
             tmp[i] = (o[i] + avg / n) * 0.5f;
         }
 
@@ -170,6 +214,38 @@ short calculateCombinedWaveform(const CombinedWaveformConfig& config, int wavefo
     return value;
 }
 
+/**
+ * Fill a range of the waveform table.
+ */
+class WaveformTask
+{
+private:
+    const CombinedWaveformConfig* cfgArray;
+    const CombinedWaveformWeights* weights;
+    matrix_t& wftable;
+
+public:
+    WaveformTask(const CombinedWaveformConfig* cfgArray, const CombinedWaveformWeights* weights, matrix_t& wftable) :
+        cfgArray(cfgArray),
+        weights(weights),
+        wftable(wftable) {}
+
+    void operator()(unsigned int begin, unsigned int end) const
+    {
+        for (unsigned int idx = begin; idx < end; idx++)
+        {
+            wftable[0][idx] = 0xfff;
+            wftable[1][idx] = static_cast<short>((idx & 0x800) == 0 ? idx << 1 : (idx ^ 0xfff) << 1);
+            wftable[2][idx] = static_cast<short>(idx);
+            wftable[3][idx] = calculateCombinedWaveform(cfgArray[0], weights[0], 3, idx);
+            wftable[4][idx] = 0xfff;
+            wftable[5][idx] = calculateCombinedWaveform(cfgArray[1], weights[1], 5, idx);
+            wftable[6][idx] = calculateCombinedWaveform(cfgArray[2], weights[2], 6, idx);
+            wftable[7][idx] = calculateCombinedWaveform(cfgArray[3], weights[3], 7, idx);
+        }
+    }
+};
+
 matrix_t* WaveformCalculator::buildTable(ChipModel model)
 {
     const CombinedWaveformConfig* cfgArray = config[model == MOS6581 ? 0 : 1];
@@ -181,18 +257,32 @@ matrix_t* WaveformCalculator::buildTable(ChipModel model)
         return &(lb->second);
     }
 
+    const size_t size = 8 * 4096 * sizeof(short);
+    const uint32_t key = TableCache::hash(cfgArray, 4 * sizeof(CombinedWaveformConfig));
+
+    const void *cached = TableCache::load("waveform", key, size);
+    if (cached != nullptr)
+    {
+        const matrix_t wftable(static_cast<short*>(const_cast<void*>(cached)), 8, 4096);
+        return &(CACHE.insert(lb, cw_cache_t::value_type(cfgArray, wftable))->second);
+    }
+
     matrix_t wftable(8, 4096);
 
-    for (unsigned int idx = 0; idx < 1 << 12; idx++)
+    CombinedWaveformWeights weights[4];
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        calculateWeights(cfgArray[i], weights[i]);
+    }
+
+    parallelFor(WaveformTask(cfgArray, weights, wftable), 1 << 12, 1 << 9);
+
+    // Share the table with other processes from now on
+    cached = TableCache::store("waveform", key, wftable.get(), size);
+    if (cached != nullptr)
     {
-        wftable[0][idx] = 0xfff;
-        wftable[1][idx] = static_cast<short>((idx & 0x800) == 0 ? idx << 1 : (idx ^ 0xfff) << 1);
-        wftable[2][idx] = static_cast<short>(idx);
-        wftable[3][idx] = calculateCombinedWaveform(cfgArray[0], 3, idx);
-        wftable[4][idx] = 0xfff;
-        wftable[5][idx] = calculateCombinedWaveform(cfgArray[1], 5, idx);
-        wftable[6][idx] = calculateCombinedWaveform(cfgArray[2], 6, idx);
-        wftable[7][idx] = calculateCombinedWaveform(cfgArray[3], 7, idx);
+        const matrix_t mapped(static_cast<short*>(const_cast<void*>(cached)), 8, 4096);
+        return &(CACHE.insert(lb, cw_cache_t::value_type(cfgArray, mapped))->second);
     }
 
     return &(CACHE.insert(lb, cw_cache_t::value_type(cfgArray, wftable))->second);
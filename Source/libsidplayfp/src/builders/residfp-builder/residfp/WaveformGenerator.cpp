@@ -24,6 +24,8 @@
 
 #include "WaveformGenerator.h"
 
+#include <algorithm>
+
 #include "Dac.h"
 
 /*
@@ -174,19 +176,85 @@ void WaveformGenerator::setWaveformModels(matrix_t* models)
     model_wave = models;
 }
 
+/**
+ * The waveform DAC tables of both chip models.
+ */
+class WaveformDac
+{
+public:
+    float table6581[1 << DAC_BITS];
+    float table8580[1 << DAC_BITS];
+
+private:
+    static void build(ChipModel chipModel, float* table)
+    {
+        Dac dacBuilder(DAC_BITS);
+        dacBuilder.kinkedDac(chipModel);
+
+        const double offset = dacBuilder.getOutput(chipModel == MOS6581 ? 0x380 : 0x9c0);
+
+        for (unsigned int i = 0; i < (1 << DAC_BITS); i++)
+        {
+            const double dacValue = dacBuilder.getOutput(i);
+            table[i] = static_cast<float>(dacValue - offset);
+        }
+    }
+
+public:
+    WaveformDac()
+    {
+        build(MOS6581, table6581);
+        build(MOS8580, table8580);
+    }
+};
+
+const float* WaveformGenerator::dacTable(ChipModel chipModel)
+{
+    static const WaveformDac dacs;
+    return chipModel == MOS6581 ? dacs.table6581 : dacs.table8580;
+}
+
 void WaveformGenerator::setChipModel(ChipModel chipModel)
 {
     is6581 = chipModel == MOS6581;
 
-    Dac dacBuilder(DAC_BITS);
-    dacBuilder.kinkedDac(chipModel);
-
-    const double offset = dacBuilder.getOutput(is6581 ? 0x380 : 0x9c0);
+    dac = dacTable(chipModel);
+}
 
-    for (unsigned int i = 0; i < (1 << DAC_BITS); i++)
+void WaveformGenerator::advance(unsigned int cycles)
+{
+    while (cycles != 0)
     {
-        const double dacValue = dacBuilder.getOutput(i);
-        dac[i] = static_cast<float>(dacValue - offset);
+        if (test || shift_pipeline != 0)
+        {
+            clock();
+            cycles--;
+            continue;
+        }
+
+        if (freq == 0)
+        {
+            msb_rising = false;
+            return;
+        }
+
+        // Steps before bit 19 rises, at 0x80000 in each 0x100000 period
+        const unsigned int low = accumulator & 0xfffff;
+        const unsigned int edge = low < 0x80000 ? 0x80000 : 0x180000;
+        const unsigned int n = std::min((edge - low - 1) / freq, cycles);
+
+        if (n == 0)
+        {
+            clock();
+            cycles--;
+            continue;
+        }
+
+        const unsigned int accumulator_old = (accumulator + (n - 1) * freq) & 0xffffff;
+        accumulator = (accumulator_old + freq) & 0xffffff;
+        msb_rising = (~accumulator_old & accumulator & 0x800000) != 0;
+
+        cycles -= n;
     }
 }
 
@@ -136,7 +136,8 @@ private:
 
     bool is6581;
 
-    float dac[4096];
+    /// The DAC table of the chip model, shared by all voices.
+    const float* dac;
 
 private:
     void clock_shift_register(unsigned int bit0);
@@ -153,6 +154,14 @@ private:
 
     void shiftregBitfade();
 
+    /**
+     * Get the DAC table of a chip model.
+     *
+     * @param chipModel the chip model
+     * @return 4096 output levels
+     */
+    static const float* dacTable(ChipModel chipModel);
+
 public:
     void setWaveformModels(matrix_t* models);
 
@@ -170,6 +179,33 @@ public:
      */
     void clock();
 
+    /**
+     * SID clocking - many cycles, without output.
+     *
+     * The accumulator is stepped in closed form between the cycles
+     * where bit 19 rises, which are clocked one by one to keep the noise
+     * shift register pipeline exact. The output latches are stale
+     * until output() has been called for two cycles.
+     *
+     * @param cycles the number of cycles
+     */
+    void advance(unsigned int cycles);
+
+    /**
+     * Check whether the output may be skipped with advance().
+     * It may not when output() feeds back into the accumulator,
+     * the shift register or the floating DAC.
+     *
+     * @return true if the output has no side effects
+     */
+    bool canAdvance() const
+    {
+        return !test
+            && waveform <= 0x8
+            && !((waveform & 2) && (waveform & 0xd) && is6581)
+            && (waveform != 0 || floating_output_ttl == 0);
+    }
+
     /**
      * Synchronize oscillators.
      * This must be done after all the oscillators have been clock()'ed,
@@ -206,7 +242,8 @@ public:
         test(false),
         sync(false),
         msb_rising(false),
-        is6581(true) {}
+        is6581(true),
+        dac(dacTable(MOS6581)) {}
 
     /**
      * Write FREQ LO register.
@@ -280,6 +317,11 @@ public:
      * Read sync value.
      */
     bool readSync() const { return sync; }
+
+    /**
+     * Check whether the ring modulator accumulator is read.
+     */
+    bool isRingModulated() const { return ring_msb_mask != 0; }
 };
 
 } // namespace reSIDfp
@@ -21,6 +21,8 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 
+#include "sidcxx11.h"
+
 /**
  * Counter.
  */
@@ -37,6 +39,7 @@ public:
 
 /**
  * Reference counted pointer to matrix wrapper, for use with standard containers.
+ * A matrix can also wrap storage owned elsewhere, which is never freed.
  */
 template<typename T>
 class matrix
@@ -53,16 +56,24 @@ public:
         x(x),
         y(y) {}
 
+    matrix(T* data, unsigned int x, unsigned int y) :
+        data(data),
+        count(nullptr),
+        x(x),
+        y(y) {}
+
     matrix(const matrix& p) :
         data(p.data),
         count(p.count),
         x(p.x),
-        y(p.y) { count->increase(); }
+        y(p.y) { if (count) count->increase(); }
 
-    ~matrix() { if (count->decrease() == 0) { delete count; delete [] data; } }
+    ~matrix() { if (count && count->decrease() == 0) { delete count; delete [] data; } }
 
     unsigned int length() const { return x * y; }
 
+    T* get() { return data; }
+
     T* operator[](unsigned int a) { return &data[a * y]; }
 
     T const* operator[](unsigned int a) const { return &data[a * y]; }
@@ -0,0 +1,72 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Build time generator of the filter model images.
+ *
+ * Usage: mkfiltertables 6581|8580
+ *
+ * Writes the image of the op-amp tables as a list of
+ * comma separated bytes to be included in an array.
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "FilterModelConfig6581.h"
+#include "FilterModelConfig8580.h"
+#include "FilterModelTables.h"
+
+namespace reSIDfp
+{
+
+// No images yet, the tables are solved.
+const unsigned char filterModelImage6581[] = { 0 };
+const size_t filterModelImage6581Size = 0;
+const unsigned char filterModelImage8580[] = { 0 };
+const size_t filterModelImage8580Size = 0;
+
+}
+
+using namespace reSIDfp;
+
+int main(int argc, char *argv[])
+{
+    std::vector<unsigned char> image;
+
+    if ((argc == 2) && !strcmp(argv[1], "6581"))
+        FilterModelConfig6581::getInstance()->getOpAmpTables().encode(image);
+    else if ((argc == 2) && !strcmp(argv[1], "8580"))
+        FilterModelConfig8580::getInstance()->getOpAmpTables().encode(image);
+    else
+    {
+        fprintf(stderr, "Usage: %s 6581|8580\n", argv[0]);
+        return 1;
+    }
+
+    for (size_t i = 0; i < image.size(); i++)
+    {
+        printf((i % 16 == 15) ? "0x%02x,\n" : "0x%02x,", image[i]);
+    }
+    printf("\n");
+
+    return ferror(stdout) ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "sidcxx11.h"
+
+#ifdef HAVE_CXX11
+#  include <atomic>
+#  include <system_error>
+#  include <thread>
+#  include <vector>
+#endif
+
+namespace reSIDfp
+{
+
+/// Upper limit of the worker threads used for building tables.
+const unsigned int MAX_WORKERS = 8;
+
+#ifdef HAVE_CXX11
+/**
+ * Worker loop of parallelFor, takes chunks until none is left.
+ */
+template<typename Task>
+void parallelWorker(const Task &task, std::atomic<unsigned int> &next, unsigned int count, unsigned int grain)
+{
+    for (;;)
+    {
+        const unsigned int begin = next.fetch_add(grain);
+        if (begin >= count)
+            break;
+        task(begin, (count - begin > grain) ? begin + grain : count);
+    }
+}
+#endif
+
+/**
+ * Run a task over the indices 0 .. count-1, in chunks
+ * of grain indices shared among worker threads.
+ * Chunks are taken in increasing order, so put
+ * the most expensive items first.
+ *
+ * The task must be a functor with a
+ * void operator()(unsigned int begin, unsigned int end) const
+ * and must not share mutable state between chunks.
+ *
+ * Without C++11 threads, or if they can't be started,
+ * the chunks run on the calling thread.
+ *
+ * @param task the task
+ * @param count the number of indices
+ * @param grain the chunk size
+ */
+template<typename Task>
+void parallelFor(const Task &task, unsigned int count, unsigned int grain = 1)
+{
+#ifdef HAVE_CXX11
+    const unsigned int chunks = (count + grain - 1) / grain;
+    unsigned int workers = std::thread::hardware_concurrency();
+    if (workers > MAX_WORKERS)
+        workers = MAX_WORKERS;
+    if (workers > chunks)
+        workers = chunks;
+
+    if (workers > 1)
+    {
+        std::atomic<unsigned int> next(0);
+        std::vector<std::thread> threads;
+
+        try
+        {
+            for (unsigned int i = 1; i < workers; i++)
+            {
+                threads.push_back(std::thread(parallelWorker<Task>, std::cref(task), std::ref(next), count, grain));
+            }
+        }
+        catch (std::system_error const &)
+        {
+            // Carry on with the threads we have
+        }
+
+        parallelWorker(task, next, count, grain);
+
+        for (std::vector<std::thread>::iterator it = threads.begin(); it != threads.end(); ++it)
+        {
+            it->join();
+        }
+
+        return;
+    }
+#endif
+
+    if (count > 0)
+        task(0, count);
+}
+
+} // namespace reSIDfp
+
+#endif
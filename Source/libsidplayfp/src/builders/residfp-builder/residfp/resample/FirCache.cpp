@@ -0,0 +1,305 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "FirCache.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+
+#include "../TableCache.h"
+
+#include "sidcxx11.h"
+
+namespace reSIDfp
+{
+
+/**
+ * A cached table.
+ *
+ * The cache slots are never freed, so a lookup can safely inspect
+ * a slot while it is being recycled for another table.
+ * refs is zero for a free slot, otherwise the cache holds
+ * one reference and each user of the table another one.
+ * The other fields are written only while refs is zero,
+ * with the mutex held, and read only while holding a reference.
+ */
+class FirCache::Entry
+{
+public:
+    std::atomic<unsigned int> refs;
+
+    /// Hash of the parameters, to skip other tables without taking a reference.
+    std::atomic<uint32_t> hash;
+
+    /// Time of the last lookup, for eviction.
+    std::atomic<unsigned int> stamp;
+
+    params_t params;
+
+    short *data;
+
+    /// Size of the table in bytes.
+    size_t size;
+
+    /// Whether the table is mapped from the TableCache.
+    bool mapped;
+
+    /// Whether the entry is a cache slot or a private table.
+    bool cached;
+
+public:
+    constexpr Entry() :
+        refs(0),
+        hash(0),
+        stamp(0),
+        params(),
+        data(nullptr),
+        size(0),
+        mapped(false),
+        cached(true) {}
+};
+
+/// The cache slots.
+static FirCache::Entry entries[FirCache::MAX_ENTRIES];
+
+/// Serializes the changes to the cache.
+static std::mutex writer;
+
+/// Memory used by the cached tables, guarded by writer.
+static size_t used = 0;
+
+/// Lookup counter, for eviction.
+static std::atomic<unsigned int> useClock(0);
+
+static uint32_t hashParams(const FirCache::params_t &params)
+{
+    uint32_t key = TableCache::hash(&params.firN, sizeof(params.firN));
+    key = TableCache::hash(&params.firRES, sizeof(params.firRES), key);
+    key = TableCache::hash(&params.cyclesPerSample, sizeof(params.cyclesPerSample), key);
+    return TableCache::hash(&params.precision, sizeof(params.precision), key);
+}
+
+static bool sameParams(const FirCache::params_t &a, const FirCache::params_t &b)
+{
+    return (a.firN == b.firN)
+        && (a.firRES == b.firRES)
+        && (a.cyclesPerSample == b.cyclesPerSample)
+        && (a.precision == b.precision);
+}
+
+/**
+ * Take a reference to a table, unless the slot is free.
+ */
+static bool ref(FirCache::Entry &entry)
+{
+    unsigned int refs = entry.refs.load(std::memory_order_relaxed);
+    while (refs != 0)
+    {
+        if (entry.refs.compare_exchange_weak(refs, refs + 1, std::memory_order_acquire, std::memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+static FirCache::Entry *lookup(const FirCache::params_t &params, uint32_t hash)
+{
+    for (unsigned int i = 0; i < FirCache::MAX_ENTRIES; i++)
+    {
+        FirCache::Entry &entry = entries[i];
+
+        if ((entry.hash.load(std::memory_order_relaxed) != hash) || !ref(entry))
+            continue;
+
+        if (sameParams(entry.params, params))
+        {
+            entry.stamp.store(useClock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+            return &entry;
+        }
+
+        // Recycled meanwhile, the cache still holds its reference
+        entry.refs.fetch_sub(1, std::memory_order_release);
+    }
+
+    return nullptr;
+}
+
+static void freeTable(FirCache::Entry &entry)
+{
+    if (entry.mapped)
+        TableCache::release(entry.data, entry.size);
+    else
+        delete [] entry.data;
+
+    entry.data = nullptr;
+}
+
+/**
+ * Evict the least recently used table which is not in use.
+ * Must be called with the writer lock held.
+ *
+ * @return false if no table was evicted
+ */
+static bool evict()
+{
+    FirCache::Entry *victim = nullptr;
+    unsigned int victimStamp = 0;
+
+    for (unsigned int i = 0; i < FirCache::MAX_ENTRIES; i++)
+    {
+        FirCache::Entry &entry = entries[i];
+
+        if (entry.refs.load(std::memory_order_relaxed) != 1)
+            continue;
+
+        const unsigned int stamp = entry.stamp.load(std::memory_order_relaxed);
+        if ((victim == nullptr) || (stamp < victimStamp))
+        {
+            victim = &entry;
+            victimStamp = stamp;
+        }
+    }
+
+    // Drop the cache reference, unless a lookup got the table meanwhile
+    unsigned int refs = 1;
+    if ((victim == nullptr)
+        || !victim->refs.compare_exchange_strong(refs, 0, std::memory_order_acquire, std::memory_order_relaxed))
+        return false;
+
+    victim->hash.store(0, std::memory_order_relaxed);
+    used -= victim->size;
+    freeTable(*victim);
+    return true;
+}
+
+static FirCache::Entry *freeSlot()
+{
+    for (unsigned int i = 0; i < FirCache::MAX_ENTRIES; i++)
+    {
+        // Free slots can't be taken by lookups
+        if (entries[i].refs.load(std::memory_order_relaxed) == 0)
+            return &entries[i];
+    }
+
+    return nullptr;
+}
+
+FirCache::Entry *FirCache::acquire(const params_t &params, const Builder &builder)
+{
+    const uint32_t hash = hashParams(params);
+
+    Entry *entry = lookup(params, hash);
+    if (entry != nullptr)
+        return entry;
+
+    std::lock_guard<std::mutex> lock(writer);
+
+    // Another thread may have added the table meanwhile
+    entry = lookup(params, hash);
+    if (entry != nullptr)
+        return entry;
+
+    const size_t size = params.firRES * params.firN * sizeof(short);
+    bool mapped = true;
+
+    // Computed by an earlier run, possibly by another process
+    short *data = static_cast<short*>(const_cast<void*>(TableCache::load("fir", hash, size)));
+
+    if (data == nullptr)
+    {
+        short *table = new short[params.firRES * params.firN];
+        builder.build(table);
+
+        // Share the table with other processes from now on
+        data = static_cast<short*>(const_cast<void*>(TableCache::store("fir", hash, table, size)));
+        if (data != nullptr)
+        {
+            delete [] table;
+        }
+        else
+        {
+            data = table;
+            mapped = false;
+        }
+    }
+
+    while ((used + size > MAX_MEMORY) && evict()) {}
+
+    if (used + size <= MAX_MEMORY)
+    {
+        entry = freeSlot();
+        if ((entry == nullptr) && evict())
+            entry = freeSlot();
+    }
+
+    if (entry == nullptr)
+    {
+        // The cache is full of tables in use, hand out a private one
+        entry = new Entry();
+        entry->cached = false;
+    }
+
+    entry->params = params;
+    entry->data = data;
+    entry->size = size;
+    entry->mapped = mapped;
+    entry->stamp.store(useClock.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+
+    if (entry->cached)
+    {
+        used += size;
+        entry->hash.store(hash, std::memory_order_relaxed);
+        // Publish the table, with the reference of the cache
+        entry->refs.store(2, std::memory_order_release);
+    }
+    else
+    {
+        entry->refs.store(1, std::memory_order_relaxed);
+    }
+
+    return entry;
+}
+
+void FirCache::release(Entry *entry)
+{
+    if (entry == nullptr)
+        return;
+
+    // Cached tables are freed only on eviction
+    if ((entry->refs.fetch_sub(1, std::memory_order_release) == 1) && !entry->cached)
+    {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        freeTable(*entry);
+        delete entry;
+    }
+}
+
+const short *FirCache::table(const Entry *entry)
+{
+    return entry->data;
+}
+
+size_t FirCache::memoryUsed()
+{
+    std::lock_guard<std::mutex> lock(writer);
+    return used;
+}
+
+} // namespace reSIDfp
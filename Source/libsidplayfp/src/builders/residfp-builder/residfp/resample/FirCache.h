@@ -0,0 +1,122 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef FIRCACHE_H
+#define FIRCACHE_H
+
+#include <cstddef>
+
+namespace reSIDfp
+{
+
+/**
+ * Process-wide cache of the SincResampler FIR tables.
+ *
+ * The FIR computation is expensive and sampling parameters are set often,
+ * but from a very small set of choices, so the tables are shared by all
+ * resamplers using the same parameters, from any thread.
+ *
+ * Lookups of cached tables are lock free; a mutex serializes
+ * only the computation of missing tables. Tables are reference counted
+ * and those no longer in use are evicted, least recently used first,
+ * when the cache would exceed MAX_MEMORY.
+ */
+class FirCache
+{
+public:
+    /// Upper bound of the memory used by cached tables.
+    static const size_t MAX_MEMORY = 4 << 20;
+
+    /// Number of cached tables.
+    static const unsigned int MAX_ENTRIES = 16;
+
+    /**
+     * The parameters identifying a table.
+     */
+    typedef struct
+    {
+        /// Filter length
+        int firN;
+
+        /// Filter resolution
+        int firRES;
+
+        /// Clock cycles per output sample
+        double cyclesPerSample;
+
+        /// Filter precision in bits
+        int precision;
+    } params_t;
+
+    /**
+     * Computes a table on a cache miss.
+     */
+    class Builder
+    {
+    public:
+        virtual ~Builder() {}
+
+        /**
+         * Fill a table.
+         *
+         * @param table firRES rows of firN coefficients
+         */
+        virtual void build(short *table) const = 0;
+    };
+
+    class Entry;
+
+public:
+    /**
+     * Get a table, computing it if not cached.
+     * The table stays valid until released.
+     *
+     * @param params the table parameters
+     * @param builder computes the table on a miss
+     * @return the table entry
+     */
+    static Entry *acquire(const params_t &params, const Builder &builder);
+
+    /**
+     * Release a table returned by acquire().
+     *
+     * @param entry the table entry
+     */
+    static void release(Entry *entry);
+
+    /**
+     * Get the coefficients of a table.
+     *
+     * @param entry the table entry
+     * @return firRES rows of firN coefficients
+     */
+    static const short *table(const Entry *entry);
+
+    /**
+     * Get the memory used by cached tables.
+     *
+     * @return the size in bytes
+     */
+    static size_t memoryUsed();
+};
+
+} // namespace reSIDfp
+
+#endif
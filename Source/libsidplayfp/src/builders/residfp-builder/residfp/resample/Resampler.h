@@ -37,7 +37,13 @@ namespace reSIDfp
  */
 class Resampler
 {
-protected:
+public:
+    /**
+     * Clip a resampled value to the 16 bit range.
+     *
+     * @param x the value
+     * @return the clipped sample
+     */
     inline short softClip(int x) const
     {
         constexpr int threshold = 28000;
@@ -53,6 +59,7 @@ protected:
         return static_cast<short>(value * 32768.);
     }
 
+protected:
     virtual int output() const = 0;
 
     Resampler() {}
@@ -68,6 +75,33 @@ public:
      */
     virtual bool input(int sample) = 0;
 
+    /**
+     * Input a block of samples and output the ones which are ready,
+     * same as calling input() for each sample and output()
+     * whenever a sample is ready.
+     * At most one sample is output per input sample, so the
+     * output buffer may be the same as the input one.
+     *
+     * @param samples the input samples
+     * @param count the number of input samples
+     * @param output receives the resampled values, not clipped
+     * @return the number of resampled values
+     */
+    virtual unsigned int inputBlock(const int* samples, unsigned int count, int* output)
+    {
+        unsigned int n = 0;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            if (input(samples[i]))
+            {
+                output[n++] = this->output();
+            }
+        }
+
+        return n;
+    }
+
     /**
      * Output a sample from resampler.
      *
@@ -0,0 +1,126 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "ResamplerPlanner.h"
+
+#include <cmath>
+
+#include "SincResampler.h"
+#include "TwoPassSincResampler.h"
+
+namespace reSIDfp
+{
+
+/**
+ * Another plan must be at least this much cheaper to replace Ganier's one.
+ */
+const double MARGIN = 0.75;
+
+/// Intermediate rates tried, log spaced.
+const int SEARCH_STEPS = 128;
+
+/**
+ * A call costs about as much as a hundred taps with the SIMD kernels,
+ * as timed on x86 hosts with the AVX2 and AVX512BW ones.
+ * At 96 kHz a single pass wins from about fifty taps per call,
+ * so the plans do not change with the exact figures.
+ */
+const ResamplerPlanner::cost_model_t ResamplerPlanner::DEFAULT_COST = { 4e-9, 4e-11 };
+
+/**
+ * Estimate the CPU time of a sinc pass for a second of input.
+ * Each output sample interpolates between two convolutions.
+ *
+ * @return the cost, or a negative value if the filter is too long
+ */
+static double passCost(double inputFrequency, double outputFrequency, double highestAccurateFrequency,
+        int precision, const ResamplerPlanner::cost_model_t &costModel)
+{
+    const int firN = SincResampler::filterLength(inputFrequency, outputFrequency, highestAccurateFrequency, precision);
+    if (firN > SincResampler::MAX_FILTER_LENGTH)
+        return -1.;
+
+    return inputFrequency * costModel.perCall
+        + outputFrequency * 2. * (costModel.perCall + firN * costModel.perTap);
+}
+
+static ResamplerPlanner::plan_t twoPass(double clockFrequency, double samplingFrequency, double highestAccurateFrequency,
+        double intermediateFrequency, int precision, const ResamplerPlanner::cost_model_t &costModel)
+{
+    ResamplerPlanner::plan_t plan;
+    plan.intermediateFrequency = intermediateFrequency;
+
+    const double first = passCost(clockFrequency, intermediateFrequency, highestAccurateFrequency, precision, costModel);
+    const double second = passCost(intermediateFrequency, samplingFrequency, highestAccurateFrequency, precision, costModel);
+    plan.cost = (first < 0. || second < 0.) ? -1. : first + second;
+
+    return plan;
+}
+
+ResamplerPlanner::plan_t ResamplerPlanner::plan(double clockFrequency, double samplingFrequency, double highestAccurateFrequency,
+        int precision, const cost_model_t &costModel)
+{
+    // Calculation according to Laurent Ganier. It evaluates to about 120 kHz at typical settings.
+    const double ganierFrequency = 2. * highestAccurateFrequency
+        + sqrt(2. * highestAccurateFrequency * clockFrequency
+            * (samplingFrequency - 2. * highestAccurateFrequency) / samplingFrequency);
+
+    const plan_t ganier = twoPass(clockFrequency, samplingFrequency, highestAccurateFrequency,
+        ganierFrequency, precision, costModel);
+
+    plan_t best;
+    best.intermediateFrequency = 0.;
+    best.cost = passCost(clockFrequency, samplingFrequency, highestAccurateFrequency, precision, costModel);
+
+    // The first pass must decimate, and there is no gain above half the clock.
+    const double low = samplingFrequency;
+    const double ratio = pow(clockFrequency / 2. / low, 1. / SEARCH_STEPS);
+
+    double intermediateFrequency = low;
+    for (int i = 1; i < SEARCH_STEPS; i++)
+    {
+        intermediateFrequency *= ratio;
+
+        const plan_t candidate = twoPass(clockFrequency, samplingFrequency, highestAccurateFrequency,
+            intermediateFrequency, precision, costModel);
+
+        if (candidate.cost >= 0. && (best.cost < 0. || candidate.cost < best.cost))
+            best = candidate;
+    }
+
+    if (ganier.cost < 0.)
+        return best.cost < 0. ? ganier : best;
+
+    return (best.cost >= 0. && best.cost < MARGIN * ganier.cost) ? best : ganier;
+}
+
+Resampler *ResamplerPlanner::create(double clockFrequency, double samplingFrequency, double highestAccurateFrequency,
+        int precision, bool highResolution)
+{
+    const plan_t chosen = plan(clockFrequency, samplingFrequency, highestAccurateFrequency, precision, DEFAULT_COST);
+
+    if (chosen.intermediateFrequency == 0.)
+        return new SincResampler(clockFrequency, samplingFrequency, highestAccurateFrequency, precision, highResolution);
+
+    return new TwoPassSincResampler(clockFrequency, samplingFrequency, highestAccurateFrequency,
+        chosen.intermediateFrequency, precision, highResolution);
+}
+
+} // namespace reSIDfp
@@ -0,0 +1,103 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef RESAMPLERPLANNER_H
+#define RESAMPLERPLANNER_H
+
+#include "Resampler.h"
+
+namespace reSIDfp
+{
+
+/**
+ * Choose the cheapest sinc resampler for the requested quality.
+ *
+ * The candidates are a single SincResampler and a TwoPassSincResampler
+ * with any intermediate rate between the output rate and half the clock.
+ * The cost of each is estimated from the length of its filters
+ * with a fixed cost model, so that the same settings always
+ * give the same resampler, and thus the same output, on any host.
+ *
+ * A single pass is the cheapest at high output rates, where the transition
+ * band is wide, while two passes are much cheaper at the usual 44.1/48 kHz.
+ * The intermediate rate proposed by Laurent Ganier is kept unless another
+ * plan is clearly cheaper.
+ */
+class ResamplerPlanner
+{
+public:
+    /**
+     * Cost of the convolution, in seconds.
+     */
+    typedef struct
+    {
+        /// Fixed cost of a convolution, also charged for each input sample
+        double perCall;
+
+        /// Cost of a filter tap
+        double perTap;
+    } cost_model_t;
+
+    /**
+     * A resampler configuration.
+     */
+    typedef struct
+    {
+        /// Output rate of the first pass, zero for a single pass
+        double intermediateFrequency;
+
+        /// Estimated CPU time per second of output
+        double cost;
+    } plan_t;
+
+public:
+    /// The cost model used by create().
+    static const cost_model_t DEFAULT_COST;
+
+    /**
+     * Find the cheapest configuration.
+     *
+     * @param clockFrequency System clock frequency at Hz
+     * @param samplingFrequency Desired output sampling rate
+     * @param highestAccurateFrequency end of the passband
+     * @param precision filter precision in bits, sets the stopband attenuation
+     * @param costModel the cost of the convolution
+     * @return the chosen plan
+     */
+    static plan_t plan(double clockFrequency, double samplingFrequency, double highestAccurateFrequency,
+            int precision, const cost_model_t &costModel);
+
+    /**
+     * Create the cheapest resampler.
+     *
+     * @param clockFrequency System clock frequency at Hz
+     * @param samplingFrequency Desired output sampling rate
+     * @param highestAccurateFrequency end of the passband
+     * @param precision filter precision in bits, sets the stopband attenuation
+     * @param highResolution keep the samples unclipped
+     * @return a new resampler
+     */
+    static Resampler *create(double clockFrequency, double samplingFrequency, double highestAccurateFrequency,
+            int precision, bool highResolution = false);
+};
+
+} // namespace reSIDfp
+
+#endif
@@ -23,12 +23,10 @@
 #ifndef SINCRESAMPLER_H
 #define SINCRESAMPLER_H
 
-#include "Resampler.h"
-
-#include <string>
-#include <map>
+#include <memory>
 
-#include "../array.h"
+#include "Resampler.h"
+#include "FirCache.h"
 
 #include "sidcxx11.h"
 
@@ -56,9 +54,19 @@ private:
     /// Size of the ring buffer, must be a power of 2
     static const int RINGSIZE = 2048;
 
+public:
+    /// Default precision, the full 16 bit output resolution.
+    static const int DEFAULT_PRECISION = 16;
+
+    /// Longest filter that fits in the ring buffer.
+    static const int MAX_FILTER_LENGTH = RINGSIZE - 1;
+
 private:
-    /// Table of the fir filter coefficients
-    matrix_t* firTable;
+    /// The shared fir table
+    FirCache::Entry* firEntry;
+
+    /// Table of the fir filter coefficients, firRES rows of firN
+    const short* firTable;
 
     int sampleIndex;
 
@@ -74,10 +82,40 @@ private:
 
     int outputValue;
 
+    /// Ring buffer of clipped samples
     short sample[RINGSIZE * 2];
 
+    /// Ring buffer of unclipped samples, used instead in high resolution mode
+    std::unique_ptr<int[]> const wideSample;
+
 private:
-    int fir(int subcycle);
+    template<typename T>
+    int fir(const T* ring, int subcycle);
+
+    template<typename T>
+    unsigned int inputBlock(T* ring, const int* samples, unsigned int count, int* output);
+
+    /**
+     * Clip a sample and put it in the ring buffer.
+     */
+    void write(short* ring, int input)
+    {
+        ring[sampleIndex] = ring[sampleIndex + RINGSIZE] = softClip(input);
+        sampleIndex = (sampleIndex + 1) & (RINGSIZE - 1);
+    }
+
+    /**
+     * Put an unclipped sample in the ring buffer.
+     */
+    void write(int* ring, int input)
+    {
+        ring[sampleIndex] = ring[sampleIndex + RINGSIZE] = input;
+        sampleIndex = (sampleIndex + 1) & (RINGSIZE - 1);
+    }
+
+    // prevent copying
+    SincResampler(const SincResampler&);
+    SincResampler& operator=(const SincResampler&);
 
 public:
     /**
@@ -96,17 +134,43 @@ public:
      * E.g. for a 44.1kHz sampling rate the end of passband frequency is limited
      * to slightly below 20kHz. This constraint ensures that the FIR table is not overfilled.
      *
+     * The precision sets both the stopband attenuation, about 6 dB per bit,
+     * and the resolution of the FIR tables. Lower values give shorter filters.
+     *
+     * In high resolution mode the input is kept unclipped in the ring buffer,
+     * so that the output can go beyond the 16 bit range and be clipped
+     * once by the caller, if at all. The convolution is about twice as slow.
+     *
      * @param clockFrequency System clock frequency at Hz
      * @param samplingFrequency Desired output sampling rate
      * @param highestAccurateFrequency
+     * @param precision filter precision in bits, between 8 and 16
+     * @param highResolution keep the input unclipped
      */
-    SincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency);
+    SincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, int precision = DEFAULT_PRECISION,
+            bool highResolution = false);
+
+    ~SincResampler();
 
     bool input(int input) override;
 
+    unsigned int inputBlock(const int* samples, unsigned int count, int* output) override;
+
     int output() const override { return outputValue; }
 
     void reset() override;
+
+    /**
+     * Get the length of the filter for the given parameters,
+     * which must not exceed MAX_FILTER_LENGTH.
+     *
+     * @param clockFrequency System clock frequency at Hz
+     * @param samplingFrequency Desired output sampling rate
+     * @param highestAccurateFrequency
+     * @param precision filter precision in bits
+     * @return the number of taps
+     */
+    static int filterLength(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, int precision = DEFAULT_PRECISION);
 };
 
 } // namespace reSIDfp
@@ -43,13 +43,21 @@ private:
     std::unique_ptr<SincResampler> const s1;
     std::unique_ptr<SincResampler> const s2;
 
-private:
-    TwoPassSincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, double intermediateFrequency) :
-        s1(new SincResampler(clockFrequency, intermediateFrequency, highestAccurateFrequency)),
-        s2(new SincResampler(intermediateFrequency, samplingFrequency, highestAccurateFrequency))
+public:
+    /**
+     * @param clockFrequency System clock frequency at Hz
+     * @param samplingFrequency Desired output sampling rate
+     * @param highestAccurateFrequency
+     * @param intermediateFrequency output rate of the first pass
+     * @param precision filter precision in bits
+     * @param highResolution keep the samples unclipped
+     */
+    TwoPassSincResampler(double clockFrequency, double samplingFrequency, double highestAccurateFrequency, double intermediateFrequency,
+            int precision = SincResampler::DEFAULT_PRECISION, bool highResolution = false) :
+        s1(new SincResampler(clockFrequency, intermediateFrequency, highestAccurateFrequency, precision, highResolution)),
+        s2(new SincResampler(intermediateFrequency, samplingFrequency, highestAccurateFrequency, precision, highResolution))
     {}
 
-public:
     // Named constructor
     static TwoPassSincResampler* create(double clockFrequency, double samplingFrequency, double highestAccurateFrequency)
     {
@@ -66,6 +74,12 @@ public:
         return s1->input(sample) && s2->input(s1->output());
     }
 
+    unsigned int inputBlock(const int* samples, unsigned int count, int* output) override
+    {
+        const unsigned int n = s1->inputBlock(samples, count, output);
+        return s2->inputBlock(output, n, output);
+    }
+
     int output() const override
     {
         return s2->output();
@@ -74,6 +74,21 @@ public:
         return ready;
     }
 
+    unsigned int inputBlock(const int* samples, unsigned int count, int* output) override
+    {
+        unsigned int n = 0;
+
+        for (unsigned int i = 0; i < count; i++)
+        {
+            if (ZeroOrderResampler::input(samples[i]))
+            {
+                output[n++] = outputValue;
+            }
+        }
+
+        return n;
+    }
+
     int output() const override { return outputValue; }
 
     void reset() override
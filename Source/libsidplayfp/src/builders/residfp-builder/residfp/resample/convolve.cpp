@@ -0,0 +1,422 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "convolve.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+/*
+ * On x86 with GCC or clang all the kernels are built, each for its own
+ * instruction set, and the best one is selected at runtime with CPUID.
+ * Elsewhere the SIMD kernel is chosen at configure time with --with-simd.
+ */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#  define HAVE_CPU_DISPATCH
+#  define TARGET(isa) __attribute__((target(isa)))
+#  include <immintrin.h>
+#  if defined(__clang__) || (__GNUC__ >= 7)
+#    define HAVE_AVX512BW_KERNEL
+#  endif
+#else
+#  define TARGET(isa)
+#  ifdef HAVE_EMMINTRIN_H
+#    include <emmintrin.h>
+#  elif defined HAVE_MMINTRIN_H
+#    include <mmintrin.h>
+#  elif defined(HAVE_ARM_NEON_H)
+#    include <arm_neon.h>
+#  endif
+#endif
+
+#if defined(HAVE_CPU_DISPATCH) || defined(HAVE_EMMINTRIN_H)
+#  define HAVE_SSE2_KERNEL
+#endif
+
+namespace reSIDfp
+{
+
+static bool always() { return true; }
+
+static int dotScalar(const short* a, const short* b, int bLength)
+{
+    int out = 0;
+
+    for (int i = 0; i < bLength; i++)
+    {
+        out += *a++ * *b++;
+    }
+
+    return out;
+}
+
+static int64_t dotWideScalar(const int* a, const short* b, int bLength)
+{
+    int64_t out = 0;
+
+    for (int i = 0; i < bLength; i++)
+    {
+        out += static_cast<int64_t>(*a++) * *b++;
+    }
+
+    return out;
+}
+
+#ifdef HAVE_SSE2_KERNEL
+#ifdef HAVE_CPU_DISPATCH
+static bool hasSSE2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
+#else
+#  define hasSSE2 always
+#endif
+
+TARGET("sse2")
+static int dotSSE2(const short* a, const short* b, int bLength)
+{
+    __m128i acc = _mm_setzero_si128();
+
+    const int n = bLength / 8;
+
+    for (int i = 0; i < n; i++)
+    {
+        const __m128i tmp = _mm_madd_epi16(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(a)),
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+        acc = _mm_add_epi32(acc, tmp);
+        a += 8;
+        b += 8;
+    }
+
+    __m128i vsum = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+    vsum = _mm_add_epi32(vsum, _mm_srli_si128(vsum, 4));
+    const int out = _mm_cvtsi128_si32(vsum);
+
+    return out + dotScalar(a, b, bLength & 7);
+}
+#endif
+
+#ifdef HAVE_CPU_DISPATCH
+static bool hasAVX2()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+TARGET("avx2")
+static int dotAVX2(const short* a, const short* b, int bLength)
+{
+    __m256i acc = _mm256_setzero_si256();
+
+    const int n = bLength / 16;
+
+    for (int i = 0; i < n; i++)
+    {
+        const __m256i tmp = _mm256_madd_epi16(
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+            _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+        acc = _mm256_add_epi32(acc, tmp);
+        a += 16;
+        b += 16;
+    }
+
+    __m128i vsum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    vsum = _mm_add_epi32(vsum, _mm_srli_si128(vsum, 8));
+    vsum = _mm_add_epi32(vsum, _mm_srli_si128(vsum, 4));
+    const int out = _mm_cvtsi128_si32(vsum);
+
+    return out + dotScalar(a, b, bLength & 15);
+}
+
+TARGET("avx2")
+static int64_t dotWideAVX2(const int* a, const short* b, int bLength)
+{
+    __m256i accEven = _mm256_setzero_si256();
+    __m256i accOdd = _mm256_setzero_si256();
+
+    const int n = bLength / 8;
+
+    for (int i = 0; i < n; i++)
+    {
+        const __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a));
+        const __m256i vb = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+        // 64 bit products of the even and of the odd lanes
+        accEven = _mm256_add_epi64(accEven, _mm256_mul_epi32(va, vb));
+        accOdd = _mm256_add_epi64(accOdd, _mm256_mul_epi32(_mm256_srli_epi64(va, 32), _mm256_srli_epi64(vb, 32)));
+        a += 8;
+        b += 8;
+    }
+
+    const __m256i acc = _mm256_add_epi64(accEven, accOdd);
+    __m128i vsum = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    vsum = _mm_add_epi64(vsum, _mm_srli_si128(vsum, 8));
+    int64_t out;
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&out), vsum);
+
+    return out + dotWideScalar(a, b, bLength & 7);
+}
+#endif
+
+#ifdef HAVE_AVX512BW_KERNEL
+static bool hasAVX512BW()
+{
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw");
+}
+
+/*
+ * Horizontal sum of the lanes.
+ * The masked extracts avoid the undefined sources
+ * which make GCC 12 warn about _mm512_reduce_add_epi32.
+ */
+TARGET("avx512f")
+static int sumAVX512(__m512i acc)
+{
+    const __m256i v = _mm256_add_epi32(
+        _mm512_maskz_extracti64x4_epi64(0xff, acc, 0),
+        _mm512_maskz_extracti64x4_epi64(0xff, acc, 1));
+    __m128i vsum = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    vsum = _mm_add_epi32(vsum, _mm_srli_si128(vsum, 8));
+    vsum = _mm_add_epi32(vsum, _mm_srli_si128(vsum, 4));
+    return _mm_cvtsi128_si32(vsum);
+}
+
+TARGET("avx512f,avx512bw")
+static int dotAVX512BW(const short* a, const short* b, int bLength)
+{
+    __m512i acc = _mm512_setzero_si512();
+
+    const int n = bLength / 32;
+
+    for (int i = 0; i < n; i++)
+    {
+        const __m512i tmp = _mm512_madd_epi16(_mm512_loadu_si512(a), _mm512_loadu_si512(b));
+        acc = _mm512_add_epi32(acc, tmp);
+        a += 32;
+        b += 32;
+    }
+
+    // The remaining taps with masked loads, which zero the missing ones
+    const __mmask32 mask = (1u << (bLength & 31)) - 1;
+    const __m512i tmp = _mm512_madd_epi16(_mm512_maskz_loadu_epi16(mask, a), _mm512_maskz_loadu_epi16(mask, b));
+    acc = _mm512_add_epi32(acc, tmp);
+
+    return sumAVX512(acc);
+}
+
+TARGET("avx512f,avx512bw")
+static int64_t dotWideAVX512BW(const int* a, const short* b, int bLength)
+{
+    __m512i accEven = _mm512_setzero_si512();
+    __m512i accOdd = _mm512_setzero_si512();
+
+    const int n = bLength / 16;
+
+    for (int i = 0; i < n; i++)
+    {
+        // The zero masked forms avoid the undefined sources of the plain ones
+        const __m512i va = _mm512_loadu_si512(a);
+        const __m512i vb = _mm512_maskz_cvtepi16_epi32(0xffff, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+        // 64 bit products of the even and of the odd lanes
+        accEven = _mm512_add_epi64(accEven, _mm512_maskz_mul_epi32(0xff, va, vb));
+        accOdd = _mm512_add_epi64(accOdd, _mm512_maskz_mul_epi32(0xff,
+            _mm512_maskz_srli_epi64(0xff, va, 32), _mm512_maskz_srli_epi64(0xff, vb, 32)));
+        a += 16;
+        b += 16;
+    }
+
+    const __m512i acc = _mm512_add_epi64(accEven, accOdd);
+    const __m256i v = _mm256_add_epi64(
+        _mm512_maskz_extracti64x4_epi64(0xff, acc, 0),
+        _mm512_maskz_extracti64x4_epi64(0xff, acc, 1));
+    __m128i vsum = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    vsum = _mm_add_epi64(vsum, _mm_srli_si128(vsum, 8));
+    int64_t out;
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(&out), vsum);
+
+    return out + dotWideScalar(a, b, bLength & 15);
+}
+#endif
+
+#if !defined(HAVE_SSE2_KERNEL) && defined(HAVE_MMINTRIN_H)
+static int dotMMX(const short* a, const short* b, int bLength)
+{
+    __m64 acc = _mm_setzero_si64();
+
+    const int n = bLength / 4;
+
+    for (int i = 0; i < n; i++)
+    {
+        const __m64 tmp = _mm_madd_pi16(*(__m64*)a, *(__m64*)b);
+        acc = _mm_add_pi32(acc, tmp);
+        a += 4;
+        b += 4;
+    }
+
+    const int out = _mm_cvtsi64_si32(acc) + _mm_cvtsi64_si32(_mm_srli_si64(acc, 32));
+    _mm_empty();
+
+    return out + dotScalar(a, b, bLength & 3);
+}
+#endif
+
+#if !defined(HAVE_SSE2_KERNEL) && !defined(HAVE_MMINTRIN_H) && defined(HAVE_ARM_NEON_H)
+static int dotNEON(const short* a, const short* b, int bLength)
+{
+#if (defined(__arm64__) && defined(__APPLE__)) || defined(__aarch64__)
+    int32x4_t acc1Low = vdupq_n_s32(0);
+    int32x4_t acc1High = vdupq_n_s32(0);
+    int32x4_t acc2Low = vdupq_n_s32(0);
+    int32x4_t acc2High = vdupq_n_s32(0);
+
+    const int n = bLength / 16;
+
+    for (int i = 0; i < n; i++)
+    {
+        int16x8_t v11 = vld1q_s16(a);
+        int16x8_t v12 = vld1q_s16(a + 8);
+        int16x8_t v21 = vld1q_s16(b);
+        int16x8_t v22 = vld1q_s16(b + 8);
+
+        acc1Low  = vmlal_s16(acc1Low, vget_low_s16(v11), vget_low_s16(v21));
+        acc1High = vmlal_high_s16(acc1High, v11, v21);
+        acc2Low  = vmlal_s16(acc2Low, vget_low_s16(v12), vget_low_s16(v22));
+        acc2High = vmlal_high_s16(acc2High, v12, v22);
+
+        a += 16;
+        b += 16;
+    }
+
+    bLength &= 15;
+
+    if (bLength >= 8)
+    {
+        int16x8_t v1 = vld1q_s16(a);
+        int16x8_t v2 = vld1q_s16(b);
+
+        acc1Low  = vmlal_s16(acc1Low, vget_low_s16(v1), vget_low_s16(v2));
+        acc1High = vmlal_high_s16(acc1High, v1, v2);
+
+        a += 8;
+        b += 8;
+    }
+
+    bLength &= 7;
+
+    if (bLength >= 4)
+    {
+        int16x4_t v1 = vld1_s16(a);
+        int16x4_t v2 = vld1_s16(b);
+
+        acc1Low  = vmlal_s16(acc1Low, v1, v2);
+
+        a += 4;
+        b += 4;
+    }
+
+    int32x4_t accSumsNeon = vaddq_s32(acc1Low, acc1High);
+    accSumsNeon = vaddq_s32(accSumsNeon, acc2Low);
+    accSumsNeon = vaddq_s32(accSumsNeon, acc2High);
+
+    const int out = vaddvq_s32(accSumsNeon);
+#else
+    int32x4_t acc = vdupq_n_s32(0);
+
+    const int n = bLength / 4;
+
+    for (int i = 0; i < n; i++)
+    {
+        const int16x4_t h_vec = vld1_s16(a);
+        const int16x4_t x_vec = vld1_s16(b);
+        acc = vmlal_s16(acc, h_vec, x_vec);
+        a += 4;
+        b += 4;
+    }
+
+    const int out = vgetq_lane_s32(acc, 0) +
+                    vgetq_lane_s32(acc, 1) +
+                    vgetq_lane_s32(acc, 2) +
+                    vgetq_lane_s32(acc, 3);
+#endif
+
+    return out + dotScalar(a, b, bLength & 3);
+}
+#endif
+
+const convolve_kernel_t convolveKernels[] =
+{
+#ifdef HAVE_AVX512BW_KERNEL
+    { "avx512bw", hasAVX512BW, dotAVX512BW, dotWideAVX512BW },
+#endif
+#ifdef HAVE_CPU_DISPATCH
+    { "avx2", hasAVX2, dotAVX2, dotWideAVX2 },
+#endif
+#ifdef HAVE_SSE2_KERNEL
+    { "sse2", hasSSE2, dotSSE2, dotWideScalar },
+#elif defined HAVE_MMINTRIN_H
+    { "mmx", always, dotMMX, dotWideScalar },
+#elif defined(HAVE_ARM_NEON_H)
+    { "neon", always, dotNEON, dotWideScalar },
+#endif
+    { "scalar", always, dotScalar, dotWideScalar },
+};
+
+const unsigned int convolveKernelCount = sizeof(convolveKernels) / sizeof(convolveKernels[0]);
+
+static const convolve_kernel_t& selectKernel()
+{
+    for (unsigned int i = 0; i < convolveKernelCount - 1; i++)
+    {
+        if (convolveKernels[i].supported())
+            return convolveKernels[i];
+    }
+
+    return convolveKernels[convolveKernelCount - 1];
+}
+
+/**
+ * The fastest kernel for the running CPU, selected on first use
+ * so that it is also valid in static initializers of other units.
+ */
+static const convolve_kernel_t& kernel()
+{
+    static const convolve_kernel_t& selected = selectKernel();
+    return selected;
+}
+
+int convolve(const short* a, const short* b, int bLength)
+{
+    return (kernel().dot(a, b, bLength) + (1 << 14)) >> 15;
+}
+
+int convolve(const int* a, const short* b, int bLength)
+{
+    return static_cast<int>((kernel().dotWide(a, b, bLength) + (1 << 14)) >> 15);
+}
+
+int dotProduct(const short* a, const short* b, int bLength)
+{
+    return kernel().dot(a, b, bLength);
+}
+
+} // namespace reSIDfp
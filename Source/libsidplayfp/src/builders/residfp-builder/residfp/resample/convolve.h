@@ -0,0 +1,102 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef CONVOLVE_H
+#define CONVOLVE_H
+
+#include <stdint.h>
+
+#include "dotProduct.h"
+
+namespace reSIDfp
+{
+
+/**
+ * A dot product kernel.
+ *
+ * @param a sample buffer input
+ * @param b sinc buffer
+ * @param bLength length of the sinc buffer
+ * @return the sum of the products
+ */
+typedef int (*dot_product_t)(const short* a, const short* b, int bLength);
+
+/**
+ * A dot product kernel for unclipped samples.
+ * The sum is kept in 64 bits, as samples beyond the 16 bit range
+ * times the filter coefficients can exceed 32 bits.
+ *
+ * @param a sample buffer input
+ * @param b sinc buffer
+ * @param bLength length of the sinc buffer
+ * @return the sum of the products
+ */
+typedef int64_t (*dot_product_wide_t)(const int* a, const short* b, int bLength);
+
+/**
+ * An implementation of the dot product.
+ */
+typedef struct
+{
+    /// Instruction set used
+    const char* name;
+
+    /// Check whether the running CPU supports the kernel
+    bool (*supported)();
+
+    dot_product_t dot;
+
+    dot_product_wide_t dotWide;
+} convolve_kernel_t;
+
+/**
+ * The kernels built for this platform, fastest first.
+ * The last one is the portable C++ reference.
+ */
+extern const convolve_kernel_t convolveKernels[];
+
+/// Number of entries in convolveKernels.
+extern const unsigned int convolveKernelCount;
+
+/**
+ * Calculate convolution with sample and sinc,
+ * using the fastest kernel supported by the CPU.
+ *
+ * @param a sample buffer input
+ * @param b sinc buffer
+ * @param bLength length of the sinc buffer
+ * @return convolved result
+ */
+int convolve(const short* a, const short* b, int bLength);
+
+/**
+ * Calculate convolution with unclipped samples and sinc,
+ * using the fastest kernel supported by the CPU.
+ *
+ * @param a sample buffer input
+ * @param b sinc buffer
+ * @param bLength length of the sinc buffer
+ * @return convolved result
+ */
+int convolve(const int* a, const short* b, int bLength);
+
+} // namespace reSIDfp
+
+#endif
@@ -0,0 +1,43 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef DOTPRODUCT_H
+#define DOTPRODUCT_H
+
+namespace reSIDfp
+{
+
+/**
+ * Calculate the dot product of sample and sinc,
+ * using the fastest kernel supported by the CPU.
+ * Unlike convolve() the result is not scaled.
+ *
+ * Also used by reSID, which includes only this header.
+ *
+ * @param a sample buffer input
+ * @param b sinc buffer
+ * @param bLength length of the sinc buffer
+ * @return the sum of the products
+ */
+int dotProduct(const short* a, const short* b, int bLength);
+
+} // namespace reSIDfp
+
+#endif
@@ -214,10 +214,8 @@ uint8_t MOS652X::read(uint_least8_t addr)
 {
     addr &= 0x0f;
 
-    timerA.syncWithCpu();
-    timerA.wakeUpAfterSyncWithCpu();
-    timerB.syncWithCpu();
-    timerB.wakeUpAfterSyncWithCpu();
+    timerA.syncForRead();
+    timerB.syncForRead();
 
     switch (addr)
     {
@@ -257,6 +255,11 @@ void MOS652X::write(uint_least8_t addr, uint8_t data)
     timerB.syncWithCpu();
 
     const uint8_t oldData = regs[addr];
+
+    // The TOD ticks so far follow the old 50/60 Hz setting
+    if ((addr == CRA) && ((data ^ oldData) & 0x80))
+        tod.sync();
+
     regs[addr] = data;
 
     switch (addr)
@@ -302,6 +305,8 @@ void MOS652X::write(uint_least8_t addr, uint8_t data)
             timerA.setPbToggle(true);
         }
         timerA.setControlRegister(data);
+        if ((data ^ oldData) & 0x80)
+            tod.scheduleAlarm();
         break;
     case CRB:
         if ((data & 1) && !(oldData & 1))
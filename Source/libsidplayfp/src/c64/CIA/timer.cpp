@@ -57,6 +57,31 @@ void Timer::syncWithCpu()
     ciaEventPauseTime = -1;
 }
 
+void Timer::syncForRead()
+{
+    if (ciaEventPauseTime > 0)
+    {
+        // Steady count down, the skipping event stays as it is.
+        // Take the elapsed cycles and the current one off the
+        // timer and move the start of the skip accordingly.
+        const event_clock_t elapsed = eventScheduler.getTime(EVENT_CLOCK_PHI2) - ciaEventPauseTime;
+        if (elapsed >= 0)
+        {
+            timer -= elapsed + 1;
+            ciaEventPauseTime += elapsed + 1;
+        }
+        return;
+    }
+
+    // A stopped timer with no transitions pending
+    // would just go back to sleep
+    if ((ciaEventPauseTime < 0) && (nextState() == state))
+        return;
+
+    syncWithCpu();
+    wakeUpAfterSyncWithCpu();
+}
+
 void Timer::wakeUpAfterSyncWithCpu()
 {
     ciaEventPauseTime = 0;
@@ -84,21 +109,7 @@ void Timer::clock()
         timer--;
     }
 
-    /* ciatimer.c block start */
-    int_least32_t adj = state & (CIAT_CR_START | CIAT_CR_ONESHOT | CIAT_PHI2IN);
-    if ((state & (CIAT_CR_START | CIAT_PHI2IN)) == (CIAT_CR_START | CIAT_PHI2IN))
-    {
-        adj |= CIAT_COUNT2;
-    }
-    if ((state & CIAT_COUNT2) != 0
-            || (state & (CIAT_STEP | CIAT_CR_START)) == (CIAT_STEP | CIAT_CR_START))
-    {
-        adj |= CIAT_COUNT3;
-    }
-    // CR_FLOAD -> LOAD1, CR_ONESHOT -> ONESHOT0, LOAD1 -> LOAD, ONESHOT0 -> ONESHOT
-    adj |= (state & (CIAT_CR_FLOAD | CIAT_CR_ONESHOT | CIAT_LOAD1 | CIAT_ONESHOT0)) << 8;
-    state = adj;
-    /* ciatimer.c block end */
+    state = nextState();
 
     if ((timer == 0) && ((state & CIAT_COUNT3) != 0))
     {
@@ -100,6 +100,12 @@ private:
      */
     void cycleSkippingEvent();
 
+    /**
+     * Get the state after the next transition,
+     * without the underflow handling.
+     */
+    inline int_least32_t nextState() const;
+
     /**
      * Execute one CIA state transition.
      */
@@ -161,6 +167,15 @@ public:
      */
     void syncWithCpu();
 
+    /**
+     * Bring the timer value up to date for a register read.
+     *
+     * A read does not alter the state machine, so a timer
+     * which is cycle skipping or stopped is left alone
+     * instead of being clocked through the current cycle.
+     */
+    void syncForRead();
+
     /**
      * Counterpart of syncWithCpu(),
      * starts the event ticking if it is needed.
@@ -220,6 +235,25 @@ public:
     inline bool getPb(uint8_t reg) const { return (reg & 0x04) ? pbToggle : (state & CIAT_OUT); }
 };
 
+int_least32_t Timer::nextState() const
+{
+    /* ciatimer.c block start */
+    int_least32_t adj = state & (CIAT_CR_START | CIAT_CR_ONESHOT | CIAT_PHI2IN);
+    if ((state & (CIAT_CR_START | CIAT_PHI2IN)) == (CIAT_CR_START | CIAT_PHI2IN))
+    {
+        adj |= CIAT_COUNT2;
+    }
+    if ((state & CIAT_COUNT2) != 0
+            || (state & (CIAT_STEP | CIAT_CR_START)) == (CIAT_STEP | CIAT_CR_START))
+    {
+        adj |= CIAT_COUNT3;
+    }
+    // CR_FLOAD -> LOAD1, CR_ONESHOT -> ONESHOT0, LOAD1 -> LOAD, ONESHOT0 -> ONESHOT
+    adj |= (state & (CIAT_CR_FLOAD | CIAT_CR_ONESHOT | CIAT_LOAD1 | CIAT_ONESHOT0)) << 8;
+    return adj;
+    /* ciatimer.c block end */
+}
+
 void Timer::reschedule()
 {
     // There are only two subcases to consider.
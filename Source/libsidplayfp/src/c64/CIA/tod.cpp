@@ -30,9 +30,17 @@
 namespace libsidplayfp
 {
 
+/**
+ * How many counter updates to look ahead for the alarm.
+ * If there is no match the clock is brought up to date
+ * at the last one and the search starts again.
+ */
+const unsigned int ALARM_LOOKAHEAD = 600;
+
 void Tod::reset()
 {
-    cycles = 0;
+    baseTime = eventScheduler.getTime(EVENT_CLOCK_PHI1);
+    ticks = 0;
     todtickcounter = 0;
 
     memset(clock, 0, sizeof(clock));
@@ -43,11 +51,13 @@ void Tod::reset()
     isLatched = false;
     isStopped = true;
 
-    eventScheduler.schedule(*this, 0, EVENT_CLOCK_PHI1);
+    eventScheduler.cancel(*this);
 }
 
 uint8_t Tod::read(uint_least8_t reg)
 {
+    sync();
+
     // TOD clock is latched by reading Hours, and released
     // upon reading Tenths of Seconds. The counter itself
     // keeps ticking all the time.
@@ -65,6 +75,8 @@ uint8_t Tod::read(uint_least8_t reg)
 
 void Tod::write(uint_least8_t reg, uint8_t data)
 {
+    sync();
+
     switch (reg)
     {
     case TENTHS: // Time Of Day clock 1/10 s
@@ -126,46 +138,99 @@ void Tod::write(uint_least8_t reg, uint8_t data)
     {
         checkAlarm();
     }
+
+    scheduleAlarm();
 }
 
 void Tod::event()
 {
-    cycles += period;
+    sync();
+    scheduleAlarm();
+}
+
+void Tod::sync()
+{
+    const event_clock_t now = eventScheduler.getTime(eventScheduler.phase());
+    if (now < baseTime)
+        return;
 
-    // Fixed precision 25.7
-    eventScheduler.schedule(*this, cycles >> 7);
-    cycles &= 0x7F; // Just keep the decimal part
+    // Ticks happen at baseTime + floor(tick * period / 128)
+    const event_clock_t due = ((now - baseTime + 1) * (1 << 7) - 1) / period + 1;
+    if (due > ticks)
+        countTicks(due - ticks);
+}
 
-    if (!isStopped)
+void Tod::countTicks(event_clock_t count)
+{
+    ticks += count;
+
+    if (isStopped)
+        return;
+
+    // count 50/60 hz ticks
+    // wild assumption: counter is 3 bits and is not reset elsewhere
+    // FIXME: this doesnt seem to be 100% correct - apparently it is reset
+    //        in some cases
+    const unsigned int target = (cra & 0x80) ? 5 : 6;
+
+    // when the counter matches the TOD frequency
+    // it is reset and the timer is updated
+    event_clock_t next = ((target - todtickcounter - 1) & 7) + 1;
+    while (count >= next)
     {
-        // count 50/60 hz ticks
-        todtickcounter++;
-        // wild assumption: counter is 3 bits and is not reset elsewhere
-        // FIXME: this doesnt seem to be 100% correct - apparently it is reset
-        //        in some cases
-        todtickcounter &= 7;
-        // if the counter matches the TOD frequency ...
-        if (todtickcounter == ((cra & 0x80) ? 5 : 6))
-        {
-            // reset the counter and update the timer
-            todtickcounter = 0;
-            updateCounters();
-        }
+        count -= next;
+        todtickcounter = 0;
+        updateCounters();
+        next = target;
     }
+
+    todtickcounter = (todtickcounter + count) & 7;
+}
+
+void Tod::scheduleAlarm()
+{
+    eventScheduler.cancel(*this);
+
+    if (isStopped)
+        return;
+
+    const unsigned int target = (cra & 0x80) ? 5 : 6;
+
+    // The tick of the next counter update
+    event_clock_t tick = ticks + ((target - todtickcounter - 1) & 7);
+
+    uint8_t counters[4];
+    memcpy(counters, clock, sizeof(counters));
+
+    for (unsigned int i = 1; i < ALARM_LOOKAHEAD; i++)
+    {
+        advanceCounters(counters);
+        if (!memcmp(alarm, counters, sizeof(alarm)))
+            break;
+        tick += target;
+    }
+
+    eventScheduler.schedule(*this, tickTime(tick) - eventScheduler.getTime(EVENT_CLOCK_PHI1), EVENT_CLOCK_PHI1);
 }
 
 void Tod::updateCounters()
+{
+    advanceCounters(clock);
+    checkAlarm();
+}
+
+void Tod::advanceCounters(uint8_t counters[4])
 {
     // advance the counters.
     // - individual counters are all 4 bit
-    uint8_t t0 = clock[TENTHS] & 0x0f;
-    uint8_t t1 = clock[SECONDS] & 0x0f;
-    uint8_t t2 = (clock[SECONDS] >> 4) & 0x0f;
-    uint8_t t3 = clock[MINUTES] & 0x0f;
-    uint8_t t4 = (clock[MINUTES] >> 4) & 0x0f;
-    uint8_t t5 = clock[HOURS] & 0x0f;
-    uint8_t t6 = (clock[HOURS] >> 4) & 0x01;
-    uint8_t pm = clock[HOURS] & 0x80;
+    uint8_t t0 = counters[TENTHS] & 0x0f;
+    uint8_t t1 = counters[SECONDS] & 0x0f;
+    uint8_t t2 = (counters[SECONDS] >> 4) & 0x0f;
+    uint8_t t3 = counters[MINUTES] & 0x0f;
+    uint8_t t4 = (counters[MINUTES] >> 4) & 0x0f;
+    uint8_t t5 = counters[HOURS] & 0x0f;
+    uint8_t t6 = (counters[HOURS] >> 4) & 0x01;
+    uint8_t pm = counters[HOURS] & 0x80;
 
     // tenth seconds (0-9)
     t0 = (t0 + 1) & 0x0f;
@@ -220,12 +285,10 @@ void Tod::updateCounters()
         }
     }
 
-    clock[TENTHS]  = t0;
-    clock[SECONDS] = t1 | (t2 << 4);
-    clock[MINUTES] = t3 | (t4 << 4);
-    clock[HOURS]   = t5 | (t6 << 4) | pm;
-
-    checkAlarm();
+    counters[TENTHS]  = t0;
+    counters[SECONDS] = t1 | (t2 << 4);
+    counters[MINUTES] = t3 | (t4 << 4);
+    counters[HOURS]   = t5 | (t6 << 4) | pm;
 }
 
 void Tod::checkAlarm()
@@ -35,6 +35,11 @@ class MOS652X;
 
 /**
  * TOD implementation taken from Vice.
+ *
+ * The 50/60 Hz ticks are not clocked one by one but are counted
+ * from the event clock when the registers are accessed.
+ * The only scheduled event is the tick where the clock
+ * will match the alarm.
  */
 class Tod : private Event
 {
@@ -57,7 +62,12 @@ private:
     const uint8_t &cra;
     const uint8_t &crb;
 
-    event_clock_t cycles;
+    /// Time of the first tick
+    event_clock_t baseTime;
+
+    /// Number of ticks already counted
+    event_clock_t ticks;
+
     event_clock_t period;
 
     unsigned int todtickcounter;
@@ -72,9 +82,25 @@ private:
 private:
     inline void checkAlarm();
 
+    static void advanceCounters(uint8_t counters[4]);
+
     inline void updateCounters();
 
-    void event();
+    /**
+     * Get the time of a tick.
+     *
+     * @param tick the tick index
+     */
+    event_clock_t tickTime(event_clock_t tick) const { return baseTime + ((tick * period) >> 7); }
+
+    /**
+     * Count the ticks up to now.
+     *
+     * @param count the number of ticks
+     */
+    void countTicks(event_clock_t count);
+
+    void event() override;
 
 public:
     Tod(EventScheduler &scheduler, MOS652X &parent, uint8_t regs[0x10]) :
@@ -83,6 +109,8 @@ public:
         parent(parent),
         cra(regs[0x0e]),
         crb(regs[0x0f]),
+        baseTime(0),
+        ticks(0),
         period(~0), // Dummy
         todtickcounter(0)
     {}
@@ -110,6 +138,19 @@ public:
      */
     void write(uint_least8_t reg, uint8_t data);
 
+    /**
+     * Bring the clock up to date with the event scheduler.
+     * Must be called before changing the 50/60 Hz setting.
+     */
+    void sync();
+
+    /**
+     * Schedule the tick where the clock will match the alarm.
+     * Must be called after the clock, the alarm or
+     * the 50/60 Hz setting have changed.
+     */
+    void scheduleAlarm();
+
     /**
      * Set TOD period.
      *
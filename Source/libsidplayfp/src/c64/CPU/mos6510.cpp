@@ -56,7 +56,17 @@ void MOS6510::eventWithoutSteals()
 {
     const ProcessorCycle &instr = instrTable[cycleCount++];
     (this->*(instr.func)) ();
-    eventScheduler.schedule(m_nosteal, 1);
+
+    if (idleCycles == 0)
+    {
+        eventScheduler.schedule(m_nosteal, 1);
+    }
+    else
+    {
+        // Fast forward through the idle loop
+        eventScheduler.schedule(m_nosteal, idleCycles + 1);
+        idleCycles = 0;
+    }
 }
 
 /**
@@ -105,6 +115,50 @@ void MOS6510::eventWithSteals()
     }
 }
 
+/**
+ * Check for an idle loop, like the classic JMP *, which only reads
+ * the same few bytes over and over and thus cannot change the state
+ * of the machine until some other chip fires an event.
+ * Whole iterations of the loop that fit before the next pending event
+ * are skipped, the result is the same as executing them cycle by cycle.
+ *
+ * Must be called at the end of an iteration.
+ *
+ * @param addr address of the looping instruction
+ * @param loopCycles number of cycles for each iteration
+ */
+void MOS6510::checkIdleLoop(uint_least16_t addr, unsigned int loopCycles)
+{
+#ifdef DEBUG
+    if (dodump)
+        return;
+#endif
+
+    // The loop reads up to three bytes from its address:
+    // they must not be in the processor port nor in the I/O area
+    // as reading from there may have side effects
+    const unsigned int lastAddr = addr + 2;
+    if ((addr < 0x0002)
+        || (lastAddr > 0xffff)
+        || ((lastAddr >= 0xd000) && (addr < 0xe000)))
+        return;
+
+    // An interrupt would break the loop
+    if (checkInterrupts() || (interruptCycle != MAX))
+        return;
+
+    // The last skipped cycle must happen before the next event
+    const event_clock_t delay = eventScheduler.nextEventDelay();
+    if (delay > (IDLE_MAX_CYCLES << 1))
+    {
+        idleCycles = IDLE_MAX_CYCLES - (IDLE_MAX_CYCLES % loopCycles);
+    }
+    else if (delay > 0)
+    {
+        idleCycles = ((delay - 1) / (loopCycles << 1)) * loopCycles;
+    }
+}
+
 void MOS6510::removeIRQ()
 {
     if (!rstFlag && !nmiFlag && (interruptCycle != MAX))
@@ -233,6 +287,9 @@ void MOS6510::interruptsAndNextOpcode()
 
         instrStartPC = -1;
 #endif
+        if (profiling)
+            profiler->instruction(eventScheduler.getTime(EVENT_CLOCK_PHI2), Register_ProgramCounter, MOS6510Profile::INTERRUPT);
+
         cpuRead(Register_ProgramCounter);
         cycleCount = BRKn << 3;
         d1x1 = true;
@@ -258,6 +315,10 @@ void MOS6510::fetchNextOpcode()
     rdyOnThrowAwayRead = false;
 
     cycleCount = cpuRead(Register_ProgramCounter) << 3;
+
+    if (profiling)
+        profiler->instruction(eventScheduler.getTime(EVENT_CLOCK_PHI2), Register_ProgramCounter, cycleCount >> 3);
+
     Register_ProgramCounter++;
 
     if (!checkInterrupts())
@@ -618,6 +679,16 @@ void MOS6510::WasteCycle() {}
 
 void MOS6510::brkPushLowPC()
 {
+    if (profiling)
+    {
+        const MOS6510Profile::interrupt_t type =
+            rstFlag ? MOS6510Profile::RST :
+            nmiFlag ? MOS6510Profile::NMI :
+            d1x1 ? MOS6510Profile::IRQ : MOS6510Profile::BRK;
+        // PC high has already been pushed
+        profiler->interrupt(type, Register_StackPointer + 1);
+    }
+
     PushLowPC();
 
     if (rstFlag)
@@ -663,9 +734,16 @@ void MOS6510::cli_instr()
 
 void MOS6510::jmp_instr()
 {
+    const bool selfLoop = ((cycleCount >> 3) == JMPw)
+        && (Cycle_EffectiveAddress == ((Register_ProgramCounter - 3) & 0xffff));
+
     Register_ProgramCounter = Cycle_EffectiveAddress;
 
     interruptsAndNextOpcode();
+
+    // JMP * spins three cycles at a time
+    if (selfLoop && (cycleCount == (JMPw << 3)))
+        checkIdleLoop(Register_ProgramCounter - 1, 3);
 }
 
 void MOS6510::pha_instr()
@@ -680,6 +758,9 @@ void MOS6510::pha_instr()
  */
 void MOS6510::rti_instr()
 {
+    if (profiling)
+        profiler->returnFromInterrupt(eventScheduler.getTime(EVENT_CLOCK_PHI2), Register_StackPointer);
+
     Register_ProgramCounter = Cycle_EffectiveAddress;
     interruptsAndNextOpcode();
 
@@ -981,6 +1062,11 @@ void MOS6510::branch_instr(bool condition)
             // Hack: delay the interrupt past this instruction.
             if (interruptCycle >> 3 == cycleCount >> 3)
                 interruptCycle += 2;
+
+            // Branch to itself, spins three cycles at a time
+            // as no flags can change within the loop
+            if (Cycle_Data == 0xfe)
+                checkIdleLoop(Register_ProgramCounter, 3);
         }
     }
     else
@@ -1460,6 +1546,7 @@ MOS6510::MOS6510(EventScheduler &scheduler) :
 #ifdef DEBUG
     m_fdbg(stdout),
 #endif
+    profiling(false),
     m_nosteal("CPU-nosteal", *this, &MOS6510::eventWithoutSteals),
     m_steal("CPU-steal", *this, &MOS6510::eventWithSteals),
     clearInt("Remove IRQ", *this, &MOS6510::removeIRQ)
@@ -2160,6 +2247,11 @@ void MOS6510::Initialise()
     rdy = true;
     d1x1 = false;
 
+    idleCycles = 0;
+
+    if (profiling)
+        profiler->restart(eventScheduler.getTime(EVENT_CLOCK_PHI2));
+
     eventScheduler.schedule(m_nosteal, 0, EVENT_CLOCK_PHI2);
 }
 
@@ -2205,4 +2297,18 @@ void MOS6510::debug(bool enable, FILE *out)
 #endif
 }
 
+void MOS6510::profile(bool enable)
+{
+    if (enable && !profiling)
+    {
+        if (profiler.get() == nullptr)
+            profiler.reset(new MOS6510Profile());
+        else
+            profiler->clear();
+
+        profiler->restart(eventScheduler.getTime(EVENT_CLOCK_PHI2));
+    }
+    profiling = enable;
+}
+
 }
@@ -27,9 +27,14 @@
 #include <cstdio>
 
 #include "flags.h"
+#include "mos6510profile.h"
 #include "EventCallback.h"
 #include "EventScheduler.h"
 
+#include "sidcxx11.h"
+
+#include <memory>
+
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
 #endif
@@ -88,6 +93,9 @@ private:
     /// Stack page location
     static const uint8_t SP_PAGE = 0x01;
 
+    /// Maximum number of cycles skipped at once in an idle loop
+    static const unsigned int IDLE_MAX_CYCLES = 65536;
+
 public:
     /// Status register interrupt bit.
     static const int SR_INTERRUPT = 2;
@@ -132,6 +140,9 @@ private:
     /// The RDY pin state during last throw away read.
     bool rdyOnThrowAwayRead;
 
+    /// Cycles to skip while spinning in an idle loop
+    unsigned int idleCycles;
+
     /// Status register
     Flags flags;
 
@@ -156,6 +167,12 @@ private:
     bool dodump;
 #endif
 
+    /// Execution profile, kept after profiling is disabled
+    std::unique_ptr<MOS6510Profile> profiler;
+
+    /// Profiling enabled?
+    bool profiling;
+
     /// Table of CPU opcode implementations
     struct ProcessorCycle instrTable[0x101 << 3];
 
@@ -171,6 +188,7 @@ private:
     void eventWithoutSteals();
     void eventWithSteals();
     void removeIRQ();
+    void checkIdleLoop(uint_least16_t addr, unsigned int loopCycles);
 
     inline void Initialise();
 
@@ -333,6 +351,23 @@ public:
     static const char *credits();
 
     void debug(bool enable, FILE *out);
+
+    /**
+     * Control profiling.
+     * Enabling starts a new profile, disabling
+     * keeps the collected data available.
+     *
+     * @param enable enable/disable profiling.
+     */
+    void profile(bool enable);
+
+    /**
+     * Get the execution profile.
+     *
+     * @return the profile, nullptr if profiling was never enabled
+     */
+    const MOS6510Profile *getProfile() const { return profiler.get(); }
+
     void setRDY(bool newRDY);
 
     // Non-standard functions
@@ -0,0 +1,221 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "mos6510profile.h"
+
+#include <algorithm>
+#include <vector>
+#include <utility>
+#include <functional>
+
+namespace libsidplayfp
+{
+
+/// Number of entries in the hot page and address lists
+const unsigned int HOT_PAGES = 16;
+const unsigned int HOT_ADDRESSES = 32;
+
+typedef std::pair<event_clock_t, unsigned int> entry_t;
+
+/**
+ * Collect the non empty entries sorted by decreasing cycles.
+ */
+static void hottest(const event_clock_t *cycles, unsigned int size, unsigned int max, std::vector<entry_t> &list)
+{
+    list.clear();
+    for (unsigned int i = 0; i < size; i++)
+    {
+        if (cycles[i] != 0)
+            list.push_back(entry_t(cycles[i], i));
+    }
+
+    std::sort(list.begin(), list.end(), std::greater<entry_t>());
+
+    if (list.size() > max)
+        list.resize(max);
+}
+
+static long long toLL(event_clock_t value) { return static_cast<long long>(value); }
+
+MOS6510Profile::MOS6510Profile()
+{
+    clear();
+    restart(0);
+}
+
+void MOS6510Profile::clear()
+{
+    std::fill(opcodeCycles, opcodeCycles + 0x101, 0);
+    std::fill(opcodeCounts, opcodeCounts + 0x101, 0);
+    std::fill(addressCycles, addressCycles + 0x10000, 0);
+    std::fill(interruptCounts, interruptCounts + 4, 0);
+    std::fill(handlerHistogram, handlerHistogram + BUCKETS, 0);
+
+    handlerCount = 0;
+    handlerCycles = 0;
+    handlerMin = 0;
+    handlerMax = 0;
+}
+
+void MOS6510Profile::restart(event_clock_t time)
+{
+    lastTime = time;
+    handlerStart = time;
+    handlerSP = 0;
+    inHandler = false;
+    lastOpcode = -1;
+    lastPC = -1;
+}
+
+void MOS6510Profile::charge(event_clock_t time)
+{
+    if (lastOpcode >= 0)
+    {
+        const event_clock_t cycles = time - lastTime;
+
+        opcodeCycles[lastOpcode] += cycles;
+        opcodeCounts[lastOpcode]++;
+
+        if (lastPC >= 0)
+            addressCycles[lastPC] += cycles;
+    }
+
+    lastTime = time;
+}
+
+void MOS6510Profile::interrupt(interrupt_t type, uint8_t sp)
+{
+    interruptCounts[type]++;
+
+    if (type == RST)
+    {
+        inHandler = false;
+        return;
+    }
+
+    if (!inHandler)
+    {
+        // The sequence started with the last fetch
+        inHandler = true;
+        handlerSP = sp;
+        handlerStart = lastTime;
+    }
+}
+
+void MOS6510Profile::returnFromInterrupt(event_clock_t time, uint8_t sp)
+{
+    if (!inHandler || (sp < handlerSP))
+        return;
+
+    inHandler = false;
+
+    const event_clock_t cycles = time - handlerStart;
+
+    if ((handlerCount == 0) || (cycles < handlerMin))
+        handlerMin = cycles;
+    if (cycles > handlerMax)
+        handlerMax = cycles;
+
+    handlerCount++;
+    handlerCycles += cycles;
+
+    const event_clock_t bucket = cycles / BUCKET_CYCLES;
+    handlerHistogram[bucket < BUCKETS - 1 ? bucket : BUCKETS - 1]++;
+}
+
+void MOS6510Profile::report(FILE *out) const
+{
+    event_clock_t totalCycles = 0;
+    event_clock_t totalCount = 0;
+    for (unsigned int i = 0; i < 0x101; i++)
+    {
+        totalCycles += opcodeCycles[i];
+        totalCount += opcodeCounts[i];
+    }
+
+    fprintf(out, "{\n");
+    fprintf(out, "  \"cycles\": %lld,\n", toLL(totalCycles));
+    fprintf(out, "  \"instructions\": %lld,\n", toLL(totalCount - opcodeCounts[INTERRUPT]));
+
+    fprintf(out, "  \"interrupts\": { \"irq\": %lld, \"nmi\": %lld, \"rst\": %lld, \"brk\": %lld },\n",
+        toLL(interruptCounts[IRQ]), toLL(interruptCounts[NMI]),
+        toLL(interruptCounts[RST]), toLL(interruptCounts[BRK]));
+
+    fprintf(out, "  \"handlers\": {\n");
+    fprintf(out, "    \"count\": %lld,\n", toLL(handlerCount));
+    fprintf(out, "    \"cycles\": %lld,\n", toLL(handlerCycles));
+    fprintf(out, "    \"min\": %lld,\n", toLL(handlerMin));
+    fprintf(out, "    \"max\": %lld,\n", toLL(handlerMax));
+    fprintf(out, "    \"average\": %.1f,\n",
+        handlerCount ? static_cast<double>(handlerCycles) / static_cast<double>(handlerCount) : 0.);
+    fprintf(out, "    \"bucket_cycles\": %u,\n", BUCKET_CYCLES);
+    fprintf(out, "    \"histogram\": [");
+    for (unsigned int i = 0; i < BUCKETS; i++)
+    {
+        fprintf(out, i ? ", %lld" : "%lld", toLL(handlerHistogram[i]));
+    }
+    fprintf(out, "]\n  },\n");
+
+    std::vector<entry_t> list;
+
+    hottest(opcodeCycles, 0x101, 0x101, list);
+    fprintf(out, "  \"opcodes\": [");
+    for (std::vector<entry_t>::const_iterator it = list.begin(); it != list.end(); ++it)
+    {
+        fprintf(out, it == list.begin() ? "\n" : ",\n");
+        if (it->second == INTERRUPT)
+            fprintf(out, "    { \"opcode\": \"interrupt\", ");
+        else
+            fprintf(out, "    { \"opcode\": \"%02x\", ", it->second);
+        fprintf(out, "\"count\": %lld, \"cycles\": %lld }",
+            toLL(opcodeCounts[it->second]), toLL(it->first));
+    }
+    fprintf(out, "\n  ],\n");
+
+    event_clock_t pageCycles[0x100];
+    for (unsigned int page = 0; page < 0x100; page++)
+    {
+        pageCycles[page] = 0;
+        for (unsigned int i = 0; i < 0x100; i++)
+            pageCycles[page] += addressCycles[(page << 8) | i];
+    }
+
+    hottest(pageCycles, 0x100, HOT_PAGES, list);
+    fprintf(out, "  \"pages\": [");
+    for (std::vector<entry_t>::const_iterator it = list.begin(); it != list.end(); ++it)
+    {
+        fprintf(out, it == list.begin() ? "\n" : ",\n");
+        fprintf(out, "    { \"page\": \"%02x00\", \"cycles\": %lld }", it->second, toLL(it->first));
+    }
+    fprintf(out, "\n  ],\n");
+
+    hottest(addressCycles, 0x10000, HOT_ADDRESSES, list);
+    fprintf(out, "  \"addresses\": [");
+    for (std::vector<entry_t>::const_iterator it = list.begin(); it != list.end(); ++it)
+    {
+        fprintf(out, it == list.begin() ? "\n" : ",\n");
+        fprintf(out, "    { \"address\": \"%04x\", \"cycles\": %lld }", it->second, toLL(it->first));
+    }
+    fprintf(out, "\n  ]\n");
+
+    fprintf(out, "}\n");
+}
+
+}
@@ -0,0 +1,169 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2020 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef MOS6510PROFILE_H
+#define MOS6510PROFILE_H
+
+#include <stdint.h>
+#include <cstdio>
+
+#include "Event.h"
+
+namespace libsidplayfp
+{
+
+/**
+ * Execution profile of the 6510 CPU.
+ *
+ * Cycles are charged to an instruction when the next one is fetched,
+ * so the counts include cycles stolen by the VIC and cycles
+ * fast forwarded in idle loops.
+ * The time spent in interrupt handlers, from the interrupt sequence
+ * up to the RTI that restores the stack, gives the cost of each
+ * play call.
+ */
+class MOS6510Profile
+{
+public:
+    typedef enum
+    {
+        IRQ = 0,
+        NMI,
+        RST,
+        BRK
+    } interrupt_t;
+
+    /// Pseudo opcode for the hardware interrupt sequence
+    static const unsigned int INTERRUPT = 0x100;
+
+    /// Width in cycles of a handler histogram bucket
+    static const unsigned int BUCKET_CYCLES = 512;
+
+    /// Number of histogram buckets, the last one collects the overflows
+    static const unsigned int BUCKETS = 41;
+
+private:
+    /// Cycles and executions per opcode
+    //@{
+    event_clock_t opcodeCycles[0x101];
+    event_clock_t opcodeCounts[0x101];
+    //@}
+
+    /// Cycles per instruction address
+    event_clock_t addressCycles[0x10000];
+
+    /// Taken interrupts per type
+    event_clock_t interruptCounts[4];
+
+    /// Handler durations
+    //@{
+    event_clock_t handlerHistogram[BUCKETS];
+    event_clock_t handlerCount;
+    event_clock_t handlerCycles;
+    event_clock_t handlerMin;
+    event_clock_t handlerMax;
+    //@}
+
+    /// Time of the last instruction fetch
+    event_clock_t lastTime;
+
+    /// When the outermost handler was entered
+    event_clock_t handlerStart;
+
+    /// Stack pointer before entering the outermost handler
+    uint8_t handlerSP;
+
+    /// Running an interrupt handler?
+    bool inHandler;
+
+    /// Last fetched opcode and its address, -1 if none
+    //@{
+    int lastOpcode;
+    int_least32_t lastPC;
+    //@}
+
+private:
+    void charge(event_clock_t time);
+
+public:
+    MOS6510Profile();
+
+    /**
+     * Clear all counters.
+     */
+    void clear();
+
+    /**
+     * Drop the instruction and handler in flight,
+     * e.g. after the scheduler time has been reset.
+     *
+     * @param time current cpu time
+     */
+    void restart(event_clock_t time);
+
+    /**
+     * Account for an instruction fetch.
+     *
+     * @param time current cpu time
+     * @param pc the instruction address
+     * @param opcode the fetched opcode or #INTERRUPT
+     */
+    void instruction(event_clock_t time, uint_least16_t pc, unsigned int opcode)
+    {
+        charge(time);
+        lastOpcode = opcode;
+        lastPC = (opcode == INTERRUPT) ? -1 : pc;
+    }
+
+    /**
+     * Account for an interrupt being taken.
+     *
+     * @param type the interrupt type
+     * @param sp the stack pointer before the pushes
+     */
+    void interrupt(interrupt_t type, uint8_t sp);
+
+    /**
+     * Account for a return from interrupt.
+     *
+     * @param time current cpu time
+     * @param sp the stack pointer after the pops
+     */
+    void returnFromInterrupt(event_clock_t time, uint8_t sp);
+
+    event_clock_t getOpcodeCount(unsigned int opcode) const { return opcodeCounts[opcode]; }
+    event_clock_t getOpcodeCycles(unsigned int opcode) const { return opcodeCycles[opcode]; }
+    event_clock_t getAddressCycles(uint_least16_t addr) const { return addressCycles[addr]; }
+    event_clock_t getInterruptCount(interrupt_t type) const { return interruptCounts[type]; }
+    event_clock_t getHandlerCount() const { return handlerCount; }
+    event_clock_t getHandlerMin() const { return handlerMin; }
+    event_clock_t getHandlerMax() const { return handlerMax; }
+
+    /**
+     * Write the profile as a JSON document.
+     *
+     * @param out the destination file
+     */
+    void report(FILE *out) const;
+};
+
+}
+
+#endif // MOS6510PROFILE_H
@@ -86,6 +86,7 @@ void MOS656X::reset()
     rasterClk           = 0;
     vblanking           = false;
     lpAsserted          = false;
+    idling              = false;
 
     memset(regs, 0, sizeof(regs));
 
@@ -148,11 +149,18 @@ void MOS656X::write(uint_least8_t addr, uint8_t data)
 {
     addr &= 0x3f;
 
-    regs[addr] = data;
-
     // Sync up timers
     sync();
 
+    regs[addr] = data;
+
+    // The write may end the idle state, check again on next cycle
+    if (idling)
+    {
+        eventScheduler.cancel(*this);
+        eventScheduler.schedule(*this, 0, EVENT_CLOCK_PHI1);
+    }
+
     switch (addr)
     {
     case 0x11: // Control register 1
@@ -265,10 +273,14 @@ void MOS656X::event()
     {
         // Update x raster
         rasterClk += cycles;
-        lineCycle += cycles;
-        lineCycle %= cyclesPerLine;
+        advance(cycles);
 
         delay = (this->*clock)();
+
+        // Sleep through the lines where nothing happens
+        idling = isIdle();
+        if (idling)
+            delay = idleDelay();
     }
     else
         delay = 1;
@@ -276,6 +288,73 @@ void MOS656X::event()
     eventScheduler.schedule(*this, delay - eventScheduler.phase(), EVENT_CLOCK_PHI1);
 }
 
+void MOS656X::advance(event_clock_t cycles)
+{
+    // Only the first two cycles of a line matter
+    // as the rest are skipped when idle
+    for (;;)
+    {
+        const unsigned int next = (lineCycle == 0) ? 1 : cyclesPerLine;
+        const event_clock_t distance = next - lineCycle;
+
+        if (cycles <= distance)
+            break;
+
+        cycles -= distance;
+
+        if (next == 1)
+        {
+            lineCycle = 1;
+            vblank();
+        }
+        else
+        {
+            lineCycle = 0;
+            checkVblank();
+        }
+    }
+
+    lineCycle += cycles;
+    lineCycle %= cyclesPerLine;
+}
+
+event_clock_t MOS656X::idleDelay() const
+{
+    // Line 0 starts on its second cycle
+    if (vblanking)
+        return 1;
+
+    const unsigned int line = currentLine();
+    const unsigned int irqLine = (irqMask & IRQ_RASTER) ? readRasterLineIRQ() : maxRasters;
+    const bool badLines = areBadLinesEnabled || readDEN();
+
+    unsigned int lines = 1;
+    for (; lines < maxRasters; lines++)
+    {
+        unsigned int y = line + lines;
+        if (y >= maxRasters)
+            y -= maxRasters;
+
+        // Wake up at least once per frame
+        if (y == 0)
+            return lines * cyclesPerLine - lineCycle + 1;
+
+        if (y == irqLine)
+            break;
+
+        if (badLines
+            && (y >= FIRST_DMA_LINE)
+            && (y <= LAST_DMA_LINE)
+            && ((y & 7) == yscroll))
+            break;
+
+        if (sprites.canStartDma(y, regs))
+            break;
+    }
+
+    return lines * cyclesPerLine - lineCycle;
+}
+
 event_clock_t MOS656X::clockPAL()
 {
     event_clock_t delay = 1;
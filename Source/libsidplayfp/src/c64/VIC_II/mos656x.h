@@ -41,6 +41,11 @@ namespace libsidplayfp
 /**
  * MOS 6567/6569/6572/6573 emulation.
  * Not cycle exact but good enough for SID playback.
+ *
+ * When neither bad lines nor sprite DMA can steal the bus
+ * the raster is not clocked line by line; the state is brought
+ * up to date on register access and the chip only wakes up
+ * on lines where something visible to the CPU can happen.
  */
 class MOS656X : private Event
 {
@@ -119,6 +124,9 @@ private:
     /// Is CIA asserting lightpen?
     bool lpAsserted;
 
+    /// Is the raster skipping idle lines?
+    bool idling;
+
     /// internal IRQ flags
     uint8_t irqFlags;
 
@@ -143,6 +151,21 @@ private:
     event_clock_t clockNTSC();
     event_clock_t clockOldNTSC();
 
+    /**
+     * Advance the raster, running only the
+     * line start actions of the skipped cycles.
+     *
+     * @param cycles the number of cycles to advance
+     */
+    void advance(event_clock_t cycles);
+
+    /**
+     * Get the number of cycles up to the start of the next
+     * line where an IRQ, a bad line or sprite DMA may happen.
+     * At most a frame is skipped.
+     */
+    event_clock_t idleDelay() const;
+
     /**
      * Signal CPU interrupt if requested by VIC.
      */
@@ -199,6 +222,29 @@ private:
             && (rasterY & 7) == yscroll;
     }
 
+    /**
+     * Get the current line, rasterY is not reset
+     * until the second cycle of line 0.
+     */
+    unsigned int currentLine() const
+    {
+        return vblanking ? 0 : rasterY;
+    }
+
+    /**
+     * Check if the following cycles of the line
+     * can be skipped, i.e. the bus is not stolen.
+     * Not on the first cycle of the line as on NTSC chips the bus
+     * is released on the second one after a late bad line.
+     */
+    bool isIdle() const
+    {
+        return (lineCycle != 0)
+            && !isBadLine
+            && sprites.isIdle()
+            && !sprites.canStartDma(currentLine(), regs);
+    }
+
     /**
      * Get previous value of Y raster
      */
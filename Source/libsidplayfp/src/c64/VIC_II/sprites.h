@@ -160,6 +160,33 @@ public:
         }
     }
 
+    /**
+     * Check if the sprite DMA can start on the given line.
+     *
+     * @rasterY y raster position
+     * @regs the VIC registers
+     */
+    bool canStartDma(unsigned int rasterY, const uint8_t regs[0x40]) const
+    {
+        const uint8_t y = rasterY & 0xff;
+        uint8_t mask = 1;
+        for (unsigned int i = 0; i < SPRITES; i++, mask <<= 1)
+        {
+            if ((enable & mask) && (y == regs[(i << 1) + 1]))
+                return true;
+        }
+        return false;
+    }
+
+    /**
+     * Check if no sprite is fetched and the
+     * per line updates leave the state unchanged.
+     */
+    bool isIdle() const
+    {
+        return (dma == 0) && (memcmp(mc, mc_base, sizeof(mc)) == 0);
+    }
+
     /**
      * Check if dma is active for sprites.
      *
@@ -214,6 +214,10 @@ public:
 
     void debug(bool enable, FILE *out) { cpu.debug(enable, out); }
 
+    void profile(bool enable) { cpu.profile(enable); }
+
+    const MOS6510Profile *getProfile() const { return cpu.getProfile(); }
+
     void reset();
     void resetCpu() { cpu.reset(); }
 
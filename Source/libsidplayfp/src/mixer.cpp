@@ -73,15 +73,50 @@ void Mixer::resetBufs()
 
 void Mixer::doMix()
 {
+    const unsigned int channels = m_stereo ? 2 : 1;
+
     short *buf = m_sampleBuffer + m_sampleIndex;
 
+    if (m_direct)
+    {
+        // The chips have already put their samples in place,
+        // as for bufferpos their outputpos is identical.
+        // They still get the same dithering as the mixed ones.
+        const int directCount = m_chips.front()->outputpos();
+        for (int j = 0; j < directCount; j++)
+        {
+            const int dither = triangularDithering();
+
+            for (unsigned int ch = 0; ch < channels; ch++)
+            {
+                *buf = passthrough(*buf, dither);
+                buf++;
+            }
+        }
+        m_sampleIndex += directCount * channels;
+    }
+
     // extract buffer info now that the SID is updated.
     // clock() may update bufferpos.
     // NB: if more than one chip exists, their bufferpos is identical to first chip's.
     const int sampleCount = m_chips.front()->bufferpos();
 
     int i = 0;
-    while (i < sampleCount)
+    if (m_passthrough)
+    {
+        while (i < sampleCount && m_sampleIndex < m_sampleCount)
+        {
+            const int dither = triangularDithering();
+
+            for (size_t k = 0; k < m_buffers.size(); k++)
+            {
+                *buf++ = passthrough(m_buffers[k][i], dither);
+            }
+            m_sampleIndex += channels;
+            i++;
+        }
+    }
+    else while (i < sampleCount)
     {
         // Handle whatever output the sid has generated so far
         if (m_sampleIndex >= m_sampleCount)
@@ -113,7 +148,6 @@ void Mixer::doMix()
 
         const int dither = triangularDithering();
 
-        const unsigned int channels = m_stereo ? 2 : 1;
         for (unsigned int ch = 0; ch < channels; ch++)
         {
             const int_least32_t tmp = ((this->*(m_mix[ch]))() * m_volume[ch] + dither) / VOLUME_MAX;
@@ -127,6 +161,24 @@ void Mixer::doMix()
     const int samplesLeft = sampleCount - i;
     std::for_each(m_buffers.begin(), m_buffers.end(), bufferMove(i, samplesLeft));
     std::for_each(m_chips.begin(), m_chips.end(), bufferPos(samplesLeft));
+
+    setOutput();
+}
+
+void Mixer::setOutput()
+{
+    // Let the chips render straight into their slot of the output buffer,
+    // unless there are samples left over that must go first
+    const unsigned int channels = m_stereo ? 2 : 1;
+    const int room = (m_passthrough && m_sampleBuffer != nullptr && m_chips.front()->bufferpos() == 0)
+        ? (m_sampleCount - m_sampleIndex) / channels : 0;
+
+    m_direct = room > 0;
+
+    for (size_t k = 0; k < m_chips.size(); k++)
+    {
+        m_chips[k]->output(m_direct ? m_sampleBuffer + m_sampleIndex + k : nullptr, channels, room);
+    }
 }
 
 void Mixer::begin(short *buffer, uint_least32_t count)
@@ -134,10 +186,24 @@ void Mixer::begin(short *buffer, uint_least32_t count)
     m_sampleIndex  = 0;
     m_sampleCount  = count;
     m_sampleBuffer = buffer;
+
+    setOutput();
 }
 
 void Mixer::updateParams()
 {
+    m_passthrough = !m_chips.empty()
+        && m_chips.size() == (m_stereo ? 2u : 1u)
+        && m_fastForwardFactor == 1
+        && m_volume.size() == 2
+        && m_volume[0] == VOLUME_MAX
+        && (!m_stereo || m_volume[1] == VOLUME_MAX);
+
+    for (size_t k = 0; m_passthrough && k < m_chips.size(); k++)
+    {
+        m_passthrough = m_chips[k]->directOutput();
+    }
+
     switch (m_buffers.size())
     {
     case 1:
@@ -157,8 +223,16 @@ void Mixer::updateParams()
 
 void Mixer::clearSids()
 {
+    for (size_t k = 0; k < m_chips.size(); k++)
+    {
+        m_chips[k]->output(nullptr, 1, 0);
+    }
+
     m_chips.clear();
     m_buffers.clear();
+
+    m_passthrough = false;
+    m_direct = false;
 }
 
 void Mixer::addSid(sidemu *chip)
@@ -193,6 +267,7 @@ bool Mixer::setFastForward(int ff)
         return false;
 
     m_fastForwardFactor = ff;
+    updateParams();
     return true;
 }
 
@@ -201,6 +276,8 @@ void Mixer::setVolume(int_least32_t left, int_least32_t right)
     m_volume.clear();
     m_volume.push_back(left);
     m_volume.push_back(right);
+
+    updateParams();
 }
 
 }
@@ -80,9 +80,17 @@ private:
 
     bool m_stereo;
 
+    /// Each chip goes unchanged to its own channel
+    bool m_passthrough;
+
+    /// The chips are rendering into the output buffer
+    bool m_direct;
+
 private:
     void updateParams();
 
+    void setOutput();
+
     int triangularDithering()
     {
         const int prevValue = oldRandomValue;
@@ -90,6 +98,14 @@ private:
         return oldRandomValue - prevValue;
     }
 
+    /*
+     * A sample at full volume, dithered as the mixing does.
+     */
+    static short passthrough(short sample, int dither)
+    {
+        return static_cast<short>((sample * VOLUME_MAX + dither) / VOLUME_MAX);
+    }
+
     /*
      * Channel matrix
      *
@@ -138,7 +154,9 @@ public:
         oldRandomValue(0),
         m_fastForwardFactor(1),
         m_sampleCount(0),
-        m_stereo(false)
+        m_stereo(false),
+        m_passthrough(false),
+        m_direct(false)
     {
         m_mix.push_back(&Mixer::mono<1>);
     }
@@ -70,7 +70,8 @@ Player::Player() :
     m_tune(nullptr),
     m_errorString(ERR_NA),
     m_isPlaying(STOPPED),
-    m_rand((unsigned int)::time(0))
+    m_rand((unsigned int)::time(0)),
+    m_runEnd("Run end", *this, &Player::runEnd)
 {
     // We need at least some minimal interrupt handling
     m_c64.getMemInterface().setKernal(nullptr);
@@ -191,11 +192,21 @@ void Player::mute(unsigned int sidNum, unsigned int voice, bool enable)
 }
 
 /**
+ * Run the emulation for at least the given number of cycles.
+ * Events are not evenly spaced in time as idle periods
+ * are skipped so we can't just count them.
+ *
  * @throws MOS6510::haltInstruction
  */
-void Player::run(unsigned int events)
+void Player::run(unsigned int cycles)
 {
-    for (unsigned int i = 0; m_isPlaying && i < events; i++)
+    EventScheduler &scheduler = *m_c64.getEventScheduler();
+
+    // The chips must not be clocked for more cycles than their buffers hold
+    scheduler.schedule(m_runEnd, cycles, EVENT_CLOCK_PHI1);
+
+    const event_clock_t end = scheduler.getTime(EVENT_CLOCK_PHI1) + cycles;
+    while (m_isPlaying && scheduler.getTime(EVENT_CLOCK_PHI1) < end)
         m_c64.clock();
 }
 
@@ -339,7 +350,7 @@ bool Player::config(const SidConfig &cfg, bool force)
             const c64::cia_model_t ciaModel = getCiaModel(cfg.ciaModel);
             m_c64.setCiaModel(ciaModel);
 
-            sidParams(m_c64.getMainCpuSpeed(), cfg.frequency, cfg.samplingMethod, cfg.fastSampling);
+            sidParams(m_c64.getMainCpuSpeed(), cfg.frequency, cfg.samplingMethod, cfg.fastSampling, cfg.samplingQuality);
 
             // Configure, setup and install C64 environment/events
             initialise();
@@ -559,7 +570,8 @@ void Player::sidCreate(sidbuilder *builder, SidConfig::sid_model_t defaultModel,
 }
 
 void Player::sidParams(double cpuFreq, int frequency,
-                        SidConfig::sampling_method_t sampling, bool fastSampling)
+                        SidConfig::sampling_method_t sampling, bool fastSampling,
+                        SidConfig::sampling_quality_t quality)
 {
     for (unsigned int i = 0; ; i++)
     {
@@ -567,7 +579,7 @@ void Player::sidParams(double cpuFreq, int frequency,
         if (s == nullptr)
             break;
 
-        s->sampling((float)cpuFreq, frequency, sampling, fastSampling);
+        s->sampling((float)cpuFreq, frequency, sampling, fastSampling, quality);
     }
 }
 
@@ -582,4 +594,15 @@ bool Player::getSidStatus(unsigned int sidNum, uint8_t regs[32])
     return true;
 }
 
+bool Player::profileReport(FILE *out) const
+{
+    const MOS6510Profile *profile = m_c64.getProfile();
+
+    if (profile == nullptr)
+        return false;
+
+    profile->report(out);
+    return true;
+}
+
 }
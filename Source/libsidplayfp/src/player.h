@@ -35,6 +35,7 @@
 #include "sidrandom.h"
 #include "mixer.h"
 #include "c64/c64.h"
+#include "EventCallback.h"
 
 #ifdef HAVE_CONFIG_H
 #  include "config.h"
@@ -86,6 +87,9 @@ private:
     /// PAL/NTSC switch value
     uint8_t videoSwitch;
 
+    /// Marks the end of a run, so that idle loops are not skipped past it
+    EventCallback<Player> m_runEnd;
+
 private:
     /**
      * Get the C64 model for the current loaded tune.
@@ -122,11 +126,15 @@ private:
      * @param frequency the output sampling frequency
      * @param sampling the sampling method to use
      * @param fastSampling true to enable fast low quality resampling (only for reSID)
+     * @param quality the resampling quality (only for reSIDfp)
      */
     void sidParams(double cpuFreq, int frequency,
-                    SidConfig::sampling_method_t sampling, bool fastSampling);
+                    SidConfig::sampling_method_t sampling, bool fastSampling,
+                    SidConfig::sampling_quality_t quality);
+
+    inline void run(unsigned int cycles);
 
-    inline void run(unsigned int events);
+    void runEnd() {}
 
 public:
     Player();
@@ -154,6 +162,10 @@ public:
 
     void debug(const bool enable, FILE *out) { m_c64.debug(enable, out); }
 
+    void profile(bool enable) { m_c64.profile(enable); }
+
+    bool profileReport(FILE *out) const;
+
     void mute(unsigned int sidNum, unsigned int voice, bool enable);
 
     const char *error() const { return m_errorString; }
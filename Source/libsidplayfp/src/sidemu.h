@@ -73,6 +73,12 @@ protected:
     /// Current position in buffer
     int m_bufferpos;
 
+    /// Interleaved output block, see output()
+    short *m_output;
+    int m_outputStride;
+    int m_outputSize;
+    int m_outputPos;
+
     bool m_status;
     bool isLocked;
 
@@ -84,6 +90,10 @@ public:
         eventScheduler(nullptr),
         m_buffer(nullptr),
         m_bufferpos(0),
+        m_output(nullptr),
+        m_outputStride(1),
+        m_outputSize(0),
+        m_outputPos(0),
         m_status(true),
         isLocked(false),
         m_error("N/A") {}
@@ -123,9 +133,11 @@ public:
      * @param outputfreq
      * @param method
      * @param fast
+     * @param quality
      */
     virtual void sampling(float systemfreq SID_UNUSED, float outputfreq SID_UNUSED,
-        SidConfig::sampling_method_t method SID_UNUSED, bool fast SID_UNUSED) {}
+        SidConfig::sampling_method_t method SID_UNUSED, bool fast SID_UNUSED,
+        SidConfig::sampling_quality_t quality SID_UNUSED) {}
 
     /**
      * Get a detailed error message.
@@ -148,6 +160,33 @@ public:
      * Get the buffer.
      */
     short *buffer() const { return m_buffer; }
+
+    /**
+     * Check if the emulation can render straight
+     * into an interleaved output block.
+     */
+    virtual bool directOutput() const { return false; }
+
+    /**
+     * Render the next samples into an interleaved output block,
+     * the ones that don't fit go to the buffer as usual.
+     *
+     * @param buffer the first sample slot, nullptr to stop
+     * @param stride distance between two samples
+     * @param size room in the block, in samples
+     */
+    void output(short *buffer, int stride, int size)
+    {
+        m_output = buffer;
+        m_outputStride = stride;
+        m_outputSize = buffer != nullptr ? size : 0;
+        m_outputPos = 0;
+    }
+
+    /**
+     * Get the number of samples rendered into the output block.
+     */
+    int outputpos() const { return m_outputPos; }
 };
 
 }
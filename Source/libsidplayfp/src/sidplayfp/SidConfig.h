@@ -78,6 +78,13 @@ public:
         RESAMPLE_INTERPOLATE    ///< Resampling
     } sampling_method_t;
 
+    /// Resampling quality @since 2.3
+    typedef enum
+    {
+        HIGH_QUALITY,           ///< 20 kHz passband, 96 dB stopband
+        LOW_QUALITY             ///< 16 kHz passband, 60 dB stopband, cheaper at any rate
+    } sampling_quality_t;
+
 public:
     /**
      * Maximum power on delay.
@@ -170,6 +177,13 @@ public:
      */
     bool fastSampling;
 
+    /**
+     * Passband and stopband of the resampling filter,
+     * available only for reSIDfp.
+     * @since 2.3
+     */
+    sampling_quality_t samplingQuality;
+
     /**
      * Compare two config objects.
      *
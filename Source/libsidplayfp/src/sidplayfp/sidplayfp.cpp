@@ -101,6 +101,16 @@ void sidplayfp::debug(bool enable, FILE *out)
     sidplayer.debug(enable, out);
 }
 
+void sidplayfp::profile(bool enable)
+{
+    sidplayer.profile(enable);
+}
+
+bool sidplayfp::profileReport(FILE *out) const
+{
+    return sidplayer.profileReport(out);
+}
+
 bool sidplayfp::isPlaying() const
 {
     return sidplayer.isPlaying();
@@ -132,6 +132,26 @@ public:
      */
     void debug(bool enable, FILE *out);
 
+    /**
+     * Control CPU profiling.
+     * Enabling starts collecting a new profile,
+     * disabling keeps the results available for #profileReport().
+     *
+     * @param enable enable/disable profiling.
+     * @since 2.3
+     */
+    void profile(bool enable);
+
+    /**
+     * Write the CPU profile as a JSON document
+     * with opcode, address and play call statistics.
+     *
+     * @param out the file where to write the report.
+     * @return false if profiling was never enabled.
+     * @since 2.3
+     */
+    bool profileReport(FILE *out) const;
+
     /**
      * Mute/unmute a SID channel.
      *
@@ -143,15 +143,15 @@ bool validateAddress(uint_least8_t address)
     return true;
 }
 
-SidTuneBase* PSID::load(buffer_t& dataBuf)
+SidTuneBase* PSID::load(const uint_least8_t* dataBuf, uint_least32_t dataLen)
 {
     // File format check
-    if (dataBuf.size() < 4)
+    if (dataLen < 4)
     {
         return nullptr;
     }
 
-    const uint32_t magic = endian_big32(&dataBuf[0]);
+    const uint32_t magic = endian_big32(dataBuf);
     if ((magic != PSID_ID)
         && (magic != RSID_ID))
     {
@@ -159,7 +159,7 @@ SidTuneBase* PSID::load(buffer_t& dataBuf)
     }
 
     psidHeader pHeader;
-    readHeader(dataBuf, pHeader);
+    readHeader(dataBuf, dataLen, pHeader);
 
     std::unique_ptr<PSID> tune(new PSID());
     tune->tryLoad(pHeader);
@@ -167,18 +167,18 @@ SidTuneBase* PSID::load(buffer_t& dataBuf)
     return tune.release();
 }
 
-void PSID::readHeader(const buffer_t &dataBuf, psidHeader &hdr)
+void PSID::readHeader(const uint_least8_t* dataBuf, uint_least32_t dataLen, psidHeader &hdr)
 {
     // Due to security concerns, input must be at least as long as version 1
     // header plus 16-bit C64 load address. That is the area which will be
     // accessed.
-    if (dataBuf.size() < (psid_headerSize + 2))
+    if (dataLen < (psid_headerSize + 2))
     {
         throw loadError(ERR_TRUNCATED);
     }
 
     // Read v1 fields
-    hdr.id               = endian_big32(&dataBuf[0]);
+    hdr.id               = endian_big32(dataBuf);
     hdr.version          = endian_big16(&dataBuf[4]);
     hdr.data             = endian_big16(&dataBuf[6]);
     hdr.load             = endian_big16(&dataBuf[8]);
@@ -193,7 +193,7 @@ void PSID::readHeader(const buffer_t &dataBuf, psidHeader &hdr)
 
     if (hdr.version >= 2)
     {
-        if (dataBuf.size() < (psidv2_headerSize + 2))
+        if (dataLen < (psidv2_headerSize + 2))
         {
             throw loadError(ERR_TRUNCATED);
         }
@@ -52,7 +52,7 @@ private:
      *
      * @throw loadError
      */
-    static void readHeader(const buffer_t &dataBuf, psidHeader &hdr);
+    static void readHeader(const uint_least8_t* dataBuf, uint_least32_t dataLen, psidHeader &hdr);
 
 protected:
     PSID() {}
@@ -61,10 +61,12 @@ public:
     virtual ~PSID() {}
 
     /**
+     * The data is only read, the tune does not keep a reference to it.
+     *
      * @return pointer to a SidTune or 0 if not a PSID file
      * @throw loadError if PSID file is corrupt
      */
-    static SidTuneBase* load(buffer_t& dataBuf);
+    static SidTuneBase* load(const uint_least8_t* dataBuf, uint_least32_t dataLen);
 
     virtual const char *createMD5(char *md5) override;
 
@@ -27,7 +27,6 @@
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
-#include <iterator>
 #include <fstream>
 
 #include "SmartPtr.h"
@@ -178,7 +177,7 @@ void SidTuneBase::placeSidTuneInC64mem(sidmemory& mem)
     mem.writeMemWord(0xae, end);
 
     // Copy data from cache to the correct destination.
-    mem.fillRam(info->m_loadAddr, &cache[fileOffset], info->m_c64dataLen);
+    mem.fillRam(info->m_loadAddr, c64Data(), info->m_c64dataLen);
 }
 
 void SidTuneBase::loadFile(const char* fileName, buffer_t& bufferRef)
@@ -191,30 +190,36 @@ void SidTuneBase::loadFile(const char* fileName, buffer_t& bufferRef)
     }
 
     inFile.seekg(0, inFile.end);
-    const int fileLen = inFile.tellg();
+    const std::streamoff fileLen = inFile.tellg();
 
     if (fileLen <= 0)
     {
         throw loadError(ERR_EMPTY);
     }
 
+    // Such files could never load, don't read them
+    if (fileLen > MAX_FILELEN)
+    {
+        throw loadError(ERR_FILE_TOO_LONG);
+    }
+
     inFile.seekg(0, inFile.beg);
 
-    buffer_t fileBuf;
-    fileBuf.reserve(fileLen);
+    // Read in one go, the data is used from this buffer
+    buffer_t fileBuf(fileLen);
+    inFile.read(reinterpret_cast<char*>(&fileBuf[0]), fileLen);
 
-    try
-    {
-        fileBuf.assign(std::istreambuf_iterator<char>(inFile), std::istreambuf_iterator<char>());
-    }
-    catch (std::exception &ex)
+    if (inFile.bad())
     {
-        throw loadError(ex.what());
+        throw loadError(ERR_CANT_LOAD_FILE);
     }
 
-    if (inFile.bad())
+    // The file may have shrunk in the meantime
+    fileBuf.resize(inFile.gcount());
+
+    if (fileBuf.empty())
     {
-        throw loadError(ERR_CANT_LOAD_FILE);
+        throw loadError(ERR_EMPTY);
     }
 
     inFile.close();
@@ -248,7 +253,12 @@ SidTuneBase* SidTuneBase::getFromStdIn()
         fileBuf.push_back((uint_least8_t)datb);
     }
 
-    return getFromBuffer(&fileBuf.front(), fileBuf.size());
+    if (fileBuf.empty())
+    {
+        throw loadError(ERR_EMPTY);
+    }
+
+    return getFromBuffer(fileBuf);
 }
 
 #endif
@@ -265,14 +275,19 @@ SidTuneBase* SidTuneBase::getFromBuffer(const uint_least8_t* const buffer, uint_
         throw loadError(ERR_FILE_TOO_LONG);
     }
 
+    // The caller keeps its buffer so the tune needs a copy
     buffer_t buf1(buffer, buffer + bufferLen);
+    return getFromBuffer(buf1);
+}
 
+SidTuneBase* SidTuneBase::getFromBuffer(buffer_t& buf)
+{
     // Here test for the possible single file formats.
-    std::unique_ptr<SidTuneBase> s(PSID::load(buf1));
-    if (s.get() == nullptr) s.reset(MUS::load(buf1, true));
+    std::unique_ptr<SidTuneBase> s(PSID::load(&buf[0], buf.size()));
+    if (s.get() == nullptr) s.reset(MUS::load(buf, true));
     if (s.get() == nullptr) throw loadError(ERR_UNRECOGNIZED_FORMAT);
 
-    s->acceptSidTune("-", "-", buf1, false);
+    s->acceptSidTune("-", "-", buf, false);
     return s.release();
 }
 
@@ -377,7 +392,10 @@ SidTuneBase* SidTuneBase::getFromFiles(LoaderFunc loader, const char* fileName,
     loader(fileName, fileBuf1);
 
     // File loaded. Now check if it is in a valid single-file-format.
-    std::unique_ptr<SidTuneBase> s(PSID::load(fileBuf1));
+    std::unique_ptr<SidTuneBase> s;
+    if (!fileBuf1.empty())
+        s.reset(PSID::load(&fileBuf1[0], fileBuf1.size()));
+
     if (s.get() == nullptr)
     {
         // Try some native C64 file formats
@@ -261,6 +261,12 @@ private:  // ---------------------------------------------------------------
      */
     static SidTuneBase* getFromBuffer(const uint_least8_t* const buffer, uint_least32_t bufferLen);
 
+    /**
+     * Try to retrieve single-file sidtune from specified buffer,
+     * taking over its contents.
+     */
+    static SidTuneBase* getFromBuffer(buffer_t& buf);
+
     /**
      * Get new file name with specified extension.
      *
@@ -0,0 +1,521 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2021 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Accuracy and performance of the emulations.
+ *
+ * The bundled tunes, and any given on the command line, are rendered
+ * with every engine, sampling method, speed or quality option and
+ * sample rate. Each render runs in a process of its own and reports
+ * the CPU time per second of audio, the memory it took and how far
+ * its spectrum is from the one of the reference render, reSIDfp with
+ * high quality resampling at the highest rate.
+ *
+ * The spectra are compared in third octave bands below the Nyquist
+ * frequency of both renders, as the level difference in dB.
+ *
+ * The report is a CSV table on the standard output. The CPU time
+ * counts only the play calls, the configuration and loading of the
+ * tune are reported apart as setup time; tables built on first use
+ * fall in the former. The memory is the growth of the peak resident
+ * set of the process from before the engine was created.
+ *
+ * Usage:
+ *   benchmark [-s seconds] [tune...]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#  include <sys/resource.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+#include "sidplayfp/sidplayfp.h"
+#include "sidplayfp/SidConfig.h"
+#include "sidplayfp/SidTune.h"
+#include "sidplayfp/SidTuneInfo.h"
+#include "builders/residfp-builder/residfp.h"
+#include "builders/resid-builder/resid.h"
+
+#include "benchtunes.h"
+
+#ifdef HAVE_CONFIG_H
+#  include "config.h"
+#endif
+
+/// Third octave bands from 20 Hz to 20 kHz.
+const unsigned int BANDS = 30;
+
+const unsigned int MAX_CHANNELS = 2;
+
+/// Band level below which the reference is considered silent.
+const double SILENCE = 1e-10;
+
+/*
+ * An engine setting under test.
+ */
+typedef struct
+{
+    const char* engine;
+    const char* method;
+    const char* option;
+    bool residfp;
+    SidConfig::sampling_method_t sampling;
+    bool fast;
+    SidConfig::sampling_quality_t quality;
+} setting_t;
+
+const setting_t settings[] =
+{
+    // The reference comes first
+    { "residfp", "resample", "high", true, SidConfig::RESAMPLE_INTERPOLATE, false, SidConfig::HIGH_QUALITY },
+    { "residfp", "resample", "low", true, SidConfig::RESAMPLE_INTERPOLATE, false, SidConfig::LOW_QUALITY },
+    { "residfp", "interpolate", "-", true, SidConfig::INTERPOLATE, false, SidConfig::HIGH_QUALITY },
+    { "resid", "resample", "normal", false, SidConfig::RESAMPLE_INTERPOLATE, false, SidConfig::HIGH_QUALITY },
+    { "resid", "resample", "fast", false, SidConfig::RESAMPLE_INTERPOLATE, true, SidConfig::HIGH_QUALITY },
+    { "resid", "interpolate", "normal", false, SidConfig::INTERPOLATE, false, SidConfig::HIGH_QUALITY },
+    { "resid", "interpolate", "fast", false, SidConfig::INTERPOLATE, true, SidConfig::HIGH_QUALITY },
+};
+
+/// Highest first, for the reference.
+const unsigned int rates[] = { 96000, 48000, 44100, 22050 };
+
+/*
+ * A tune of the corpus.
+ */
+typedef struct
+{
+    std::string name;
+    std::vector<unsigned char> data;
+} tune_t;
+
+/*
+ * The figures of a render.
+ */
+typedef struct
+{
+    bool ok;
+    unsigned int channels;
+    double cpu;
+    double setup;
+    double audio;
+    long peakKb;
+    double bands[MAX_CHANNELS][BANDS];
+} result_t;
+
+double bandEdge(unsigned int band)
+{
+    return 20. * std::pow(2., band / 3.);
+}
+
+/*
+ * Average power spectrum of the output, in overlapping
+ * Hann windowed blocks of about a quarter of a second.
+ */
+class Analyzer
+{
+private:
+    const unsigned int channels;
+    const double rate;
+
+    unsigned int size;
+    std::vector<double> window;
+    double windowPower;
+
+    std::vector<std::vector<double> > input;
+    std::vector<std::vector<double> > power;
+    unsigned int fill;
+    unsigned int blocks;
+
+    std::vector<std::complex<double> > fft;
+
+private:
+    void transform()
+    {
+        const unsigned int n = size;
+
+        for (unsigned int i = 1, j = 0; i < n; i++)
+        {
+            unsigned int bit = n >> 1;
+            for (; j & bit; bit >>= 1)
+                j ^= bit;
+            j ^= bit;
+            if (i < j)
+                std::swap(fft[i], fft[j]);
+        }
+
+        for (unsigned int len = 2; len <= n; len <<= 1)
+        {
+            const double angle = -2. * M_PI / len;
+            const std::complex<double> step(std::cos(angle), std::sin(angle));
+            for (unsigned int i = 0; i < n; i += len)
+            {
+                std::complex<double> w(1.);
+                for (unsigned int k = 0; k < len / 2; k++)
+                {
+                    const std::complex<double> a = fft[i + k];
+                    const std::complex<double> b = fft[i + k + len / 2] * w;
+                    fft[i + k] = a + b;
+                    fft[i + k + len / 2] = a - b;
+                    w *= step;
+                }
+            }
+        }
+    }
+
+    void block()
+    {
+        for (unsigned int ch = 0; ch < channels; ch++)
+        {
+            for (unsigned int i = 0; i < size; i++)
+                fft[i] = input[ch][i] * window[i];
+
+            transform();
+
+            for (unsigned int k = 0; k <= size / 2; k++)
+                power[ch][k] += std::norm(fft[k]);
+
+            // Half overlap
+            std::copy(input[ch].begin() + size / 2, input[ch].end(), input[ch].begin());
+        }
+
+        fill = size / 2;
+        blocks++;
+    }
+
+public:
+    Analyzer(unsigned int channels, double rate) :
+        channels(channels),
+        rate(rate),
+        size(1),
+        windowPower(0.),
+        fill(0),
+        blocks(0)
+    {
+        while (size < rate / 4.)
+            size <<= 1;
+
+        window.resize(size);
+        for (unsigned int i = 0; i < size; i++)
+        {
+            window[i] = 0.5 - 0.5 * std::cos(2. * M_PI * i / size);
+            windowPower += window[i] * window[i];
+        }
+
+        input.assign(channels, std::vector<double>(size));
+        power.assign(channels, std::vector<double>(size / 2 + 1));
+        fft.resize(size);
+    }
+
+    /**
+     * Add interleaved samples.
+     */
+    void add(const short* buffer, unsigned int samples)
+    {
+        for (unsigned int i = 0; i < samples; i += channels)
+        {
+            for (unsigned int ch = 0; ch < channels; ch++)
+                input[ch][fill] = buffer[i + ch] / 32768.;
+
+            if (++fill == size)
+                block();
+        }
+    }
+
+    /**
+     * Get the power of the signal in each band,
+     * the ones above the Nyquist frequency are zero.
+     */
+    void bands(double result[MAX_CHANNELS][BANDS]) const
+    {
+        // By Parseval the bins add up to the mean square of the signal
+        const double scale = blocks > 0 ? 2. / (blocks * size * windowPower) : 0.;
+
+        for (unsigned int ch = 0; ch < channels; ch++)
+        {
+            for (unsigned int b = 0; b < BANDS; b++)
+            {
+                result[ch][b] = 0.;
+                if (bandEdge(b + 1) > 0.45 * rate)
+                    continue;
+
+                const unsigned int first = static_cast<unsigned int>(std::ceil(bandEdge(b) * size / rate));
+                const unsigned int last = static_cast<unsigned int>(std::ceil(bandEdge(b + 1) * size / rate));
+                for (unsigned int k = first; k < last; k++)
+                    result[ch][b] += power[ch][k] * scale;
+            }
+        }
+    }
+};
+
+long peakKb()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+double seconds(std::clock_t start)
+{
+    return static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+/*
+ * Render the start song of a tune.
+ */
+void render(const tune_t &tune, const setting_t &setting, unsigned int rate, unsigned int length, result_t &result)
+{
+    result.ok = false;
+
+    SidTune sidTune(&tune.data[0], tune.data.size());
+    if (!sidTune.getStatus())
+        return;
+    sidTune.selectSong(0);
+
+    result.channels = sidTune.getInfo()->sidChips() > 1 ? 2 : 1;
+
+    Analyzer analyzer(result.channels, rate);
+    std::vector<short> buffer(rate / 10 * result.channels);
+
+    const long startKb = peakKb();
+    const std::clock_t setupStart = std::clock();
+
+    sidbuilder *builder;
+    if (setting.residfp)
+    {
+        ReSIDfpBuilder *b = new ReSIDfpBuilder("benchmark");
+        b->create(sidTune.getInfo()->sidChips());
+        builder = b;
+    }
+    else
+    {
+        ReSIDBuilder *b = new ReSIDBuilder("benchmark");
+        b->create(sidTune.getInfo()->sidChips());
+        builder = b;
+    }
+
+    sidplayfp engine;
+    SidConfig config = engine.config();
+    config.sidEmulation = builder;
+    config.frequency = rate;
+    config.playback = result.channels > 1 ? SidConfig::STEREO : SidConfig::MONO;
+    config.samplingMethod = setting.sampling;
+    config.fastSampling = setting.fast;
+    config.samplingQuality = setting.quality;
+    config.powerOnDelay = 0x1267;
+
+    if (builder->getStatus() && engine.config(config) && engine.load(&sidTune))
+    {
+        result.setup = seconds(setupStart);
+        result.cpu = 0.;
+
+        for (unsigned int i = 0; i < length * 10; i++)
+        {
+            const std::clock_t start = std::clock();
+            const unsigned int samples = engine.play(&buffer[0], buffer.size());
+            result.cpu += seconds(start);
+
+            analyzer.add(&buffer[0], samples);
+        }
+
+        result.audio = length;
+        result.peakKb = peakKb() - startKb;
+        analyzer.bands(result.bands);
+        result.ok = true;
+    }
+
+    engine.load(nullptr);
+    delete builder;
+}
+
+/*
+ * Render in a process of its own, for the memory figures.
+ */
+void renderApart(const tune_t &tune, const setting_t &setting, unsigned int rate, unsigned int length, result_t &result)
+{
+#ifndef _WIN32
+    int fd[2];
+    if (pipe(fd) == 0)
+    {
+        fflush(stdout);
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(fd[0]);
+            render(tune, setting, rate, length, result);
+            const ssize_t written = write(fd[1], &result, sizeof(result));
+            _exit(written == sizeof(result) ? 0 : 1);
+        }
+        close(fd[1]);
+
+        bool ok = false;
+        if (pid > 0)
+        {
+            ok = read(fd[0], &result, sizeof(result)) == sizeof(result);
+            int status;
+            waitpid(pid, &status, 0);
+        }
+        close(fd[0]);
+
+        if (!ok)
+            result.ok = false;
+        return;
+    }
+#endif
+    render(tune, setting, rate, length, result);
+}
+
+/*
+ * Print a row of the report, with the spectral difference
+ * in the bands where the reference is not silent.
+ */
+void report(const tune_t &tune, const setting_t &setting, unsigned int rate, const result_t &result, const result_t &reference)
+{
+    double sum = 0.;
+    double worst = 0.;
+    unsigned int bands = 0;
+
+    for (unsigned int ch = 0; ch < result.channels; ch++)
+    {
+        for (unsigned int b = 0; b < BANDS; b++)
+        {
+            if (result.bands[ch][b] == 0. || reference.bands[ch][b] < SILENCE)
+                continue;
+
+            const double difference = 10. * std::log10(result.bands[ch][b] / reference.bands[ch][b]);
+            sum += difference * difference;
+            worst = std::max(worst, std::fabs(difference));
+            bands++;
+        }
+    }
+
+    printf("%s,%u,%s,%s,%s,%u,%.5f,%.3f,%ld,%.3f,%.3f,%u\n",
+        tune.name.c_str(), result.channels,
+        setting.engine, setting.method, setting.option, rate,
+        result.cpu / result.audio, result.setup, result.peakKb,
+        bands > 0 ? std::sqrt(sum / bands) : 0., worst, bands);
+    fflush(stdout);
+}
+
+bool readFile(const char* fileName, std::vector<unsigned char> &data)
+{
+    FILE* f = fopen(fileName, "rb");
+    if (f == nullptr)
+        return false;
+
+    unsigned char chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), f)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+
+    fclose(f);
+    return !data.empty();
+}
+
+void addTune(std::vector<tune_t> &corpus, const char* name, const unsigned char* data, size_t size)
+{
+    tune_t tune;
+    tune.name = name;
+    tune.data.assign(data, data + size);
+    corpus.push_back(tune);
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int length = 20;
+
+    std::vector<tune_t> corpus;
+    addTune(corpus, "bundled/vbi", tuneVbi, sizeof(tuneVbi));
+    addTune(corpus, "bundled/cia", tuneCia, sizeof(tuneCia));
+    addTune(corpus, "bundled/2sid", tune2Sid, sizeof(tune2Sid));
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-s") && i + 1 < argc)
+        {
+            length = atoi(argv[++i]);
+            continue;
+        }
+
+        tune_t tune;
+        tune.name = argv[i];
+        if (argv[i][0] == '-' || !readFile(argv[i], tune.data))
+        {
+            fprintf(stderr, "Usage: %s [-s seconds] [tune...]\n", argv[0]);
+            return 1;
+        }
+        corpus.push_back(tune);
+    }
+
+    if (length == 0)
+        length = 1;
+
+    printf("tune,channels,engine,method,option,rate,cpu_per_second,setup_seconds,peak_kb,spectral_rms_db,spectral_max_db,bands\n");
+
+    const unsigned int nSettings = sizeof(settings) / sizeof(settings[0]);
+    const unsigned int nRates = sizeof(rates) / sizeof(rates[0]);
+
+    for (std::vector<tune_t>::const_iterator tune = corpus.begin(); tune != corpus.end(); ++tune)
+    {
+        result_t reference;
+        renderApart(*tune, settings[0], rates[0], length, reference);
+        if (!reference.ok)
+        {
+            fprintf(stderr, "%s: cannot render the reference\n", tune->name.c_str());
+            continue;
+        }
+
+        for (unsigned int s = 0; s < nSettings; s++)
+        {
+            for (unsigned int r = 0; r < nRates; r++)
+            {
+                fprintf(stderr, "%s %s %s %s %u\n", tune->name.c_str(),
+                    settings[s].engine, settings[s].method, settings[s].option, rates[r]);
+
+                result_t result;
+                if (s == 0 && r == 0)
+                    result = reference;
+                else
+                    renderApart(*tune, settings[s], rates[r], length, result);
+
+                if (result.ok)
+                    report(*tune, settings[s], rates[r], result, reference);
+                else
+                    fprintf(stderr, "%s: render failed\n", tune->name.c_str());
+            }
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright 2011-2021 Leandro Nini <drfiemost@users.sourceforge.net>
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#ifndef BENCHTUNES_H
+#define BENCHTUNES_H
+
+/*
+ * Tunes for the benchmark, small PSID files made for it.
+ *
+ * The play routine sweeps the pitch, pulse width, filter cutoff
+ * and resonance of all the voices with a frame counter, changing
+ * the waveforms and the filter mode as it goes, and gates the voices
+ * off every other 256 frames to include the release phases.
+ */
+
+/// 6581, PAL, played on vertical blank
+const unsigned char tuneVbi[] =
+{
+    0x50, 0x53, 0x49, 0x44, 0x00, 0x02, 0x00, 0x7c, 0x00, 0x00, 0x10, 0x00, 0x10, 0x43, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x30, 0x32, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0xa9, 0x00,
+    0x85, 0xfb, 0x85, 0xfc, 0xa2, 0x18, 0xa9, 0x00, 0x9d, 0x00, 0xd4, 0xca, 0x10, 0xfa, 0xa9, 0x09,
+    0x8d, 0x05, 0xd4, 0xa9, 0xa4, 0x8d, 0x06, 0xd4, 0xa9, 0x22, 0x8d, 0x0c, 0xd4, 0xa9, 0x88, 0x8d,
+    0x0d, 0xd4, 0xa9, 0x55, 0x8d, 0x13, 0xd4, 0xa9, 0xf9, 0x8d, 0x14, 0xd4, 0xa9, 0x00, 0x8d, 0x02,
+    0xd4, 0xa9, 0x08, 0x8d, 0x03, 0xd4, 0xa9, 0x77, 0x8d, 0x17, 0xd4, 0xa9, 0x1f, 0x8d, 0x18, 0xd4,
+    0x60, 0xe6, 0xfb, 0xd0, 0x02, 0xe6, 0xfc, 0xa5, 0xfb, 0x49, 0x00, 0x8d, 0x00, 0xd4, 0x4a, 0x4a,
+    0x09, 0x08, 0x8d, 0x01, 0xd4, 0xa5, 0xfb, 0x29, 0x0f, 0x8d, 0x03, 0xd4, 0xa5, 0xfb, 0x0a, 0x8d,
+    0x08, 0xd4, 0xa5, 0xfb, 0x49, 0x3c, 0x8d, 0x0f, 0xd4, 0xa5, 0xfb, 0x8d, 0x16, 0xd4, 0xa5, 0xfb,
+    0x4a, 0x4a, 0x29, 0x30, 0x09, 0x0f, 0x8d, 0x18, 0xd4, 0xa5, 0xfc, 0x29, 0x01, 0xf0, 0x12, 0xa9,
+    0x40, 0x8d, 0x04, 0xd4, 0xa9, 0x20, 0x8d, 0x0b, 0xd4, 0xa9, 0x10, 0x8d, 0x12, 0xd4, 0x4c, 0xc0,
+    0x10, 0xa5, 0xfb, 0x4a, 0x4a, 0x4a, 0x4a, 0x29, 0x01, 0x09, 0x40, 0x8d, 0x04, 0xd4, 0xa5, 0xfb,
+    0x29, 0x20, 0xf0, 0x05, 0xa9, 0x21, 0x4c, 0xad, 0x10, 0xa9, 0x20, 0x8d, 0x0b, 0xd4, 0xa5, 0xfb,
+    0x29, 0x48, 0xf0, 0x05, 0xa9, 0x81, 0x4c, 0xbd, 0x10, 0xa9, 0x15, 0x8d, 0x12, 0xd4, 0x60,
+};
+
+/// 8580, PAL, played on CIA timer
+const unsigned char tuneCia[] =
+{
+    0x50, 0x53, 0x49, 0x44, 0x00, 0x02, 0x00, 0x7c, 0x00, 0x00, 0x10, 0x00, 0x10, 0x43, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x30, 0x32, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10, 0xa9, 0x00,
+    0x85, 0xfb, 0x85, 0xfc, 0xa2, 0x18, 0xa9, 0x00, 0x9d, 0x00, 0xd4, 0xca, 0x10, 0xfa, 0xa9, 0x09,
+    0x8d, 0x05, 0xd4, 0xa9, 0xa4, 0x8d, 0x06, 0xd4, 0xa9, 0x22, 0x8d, 0x0c, 0xd4, 0xa9, 0x88, 0x8d,
+    0x0d, 0xd4, 0xa9, 0x55, 0x8d, 0x13, 0xd4, 0xa9, 0xf9, 0x8d, 0x14, 0xd4, 0xa9, 0x00, 0x8d, 0x02,
+    0xd4, 0xa9, 0x08, 0x8d, 0x03, 0xd4, 0xa9, 0x77, 0x8d, 0x17, 0xd4, 0xa9, 0x1f, 0x8d, 0x18, 0xd4,
+    0x60, 0xe6, 0xfb, 0xd0, 0x02, 0xe6, 0xfc, 0xa5, 0xfb, 0x49, 0x00, 0x8d, 0x00, 0xd4, 0x4a, 0x4a,
+    0x09, 0x08, 0x8d, 0x01, 0xd4, 0xa5, 0xfb, 0x29, 0x0f, 0x8d, 0x03, 0xd4, 0xa5, 0xfb, 0x0a, 0x8d,
+    0x08, 0xd4, 0xa5, 0xfb, 0x49, 0x3c, 0x8d, 0x0f, 0xd4, 0xa5, 0xfb, 0x8d, 0x16, 0xd4, 0xa5, 0xfb,
+    0x4a, 0x4a, 0x29, 0x30, 0x09, 0x0f, 0x8d, 0x18, 0xd4, 0xa5, 0xfc, 0x29, 0x01, 0xf0, 0x12, 0xa9,
+    0x40, 0x8d, 0x04, 0xd4, 0xa9, 0x20, 0x8d, 0x0b, 0xd4, 0xa9, 0x10, 0x8d, 0x12, 0xd4, 0x4c, 0xc0,
+    0x10, 0xa5, 0xfb, 0x4a, 0x4a, 0x4a, 0x4a, 0x29, 0x01, 0x09, 0x40, 0x8d, 0x04, 0xd4, 0xa5, 0xfb,
+    0x29, 0x20, 0xf0, 0x05, 0xa9, 0x21, 0x4c, 0xad, 0x10, 0xa9, 0x20, 0x8d, 0x0b, 0xd4, 0xa5, 0xfb,
+    0x29, 0x48, 0xf0, 0x05, 0xa9, 0x81, 0x4c, 0xbd, 0x10, 0xa9, 0x15, 0x8d, 0x12, 0xd4, 0x60,
+};
+
+/// two 8580 at $D400 and $D420, stereo
+const unsigned char tune2Sid[] =
+{
+    0x50, 0x53, 0x49, 0x44, 0x00, 0x03, 0x00, 0x7c, 0x00, 0x00, 0x10, 0x00, 0x10, 0x7f, 0x00, 0x01,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x74, 0x65, 0x73, 0x74, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x32, 0x30, 0x32, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xa4, 0x00, 0x00, 0x42, 0x00, 0x00, 0x10, 0xa9, 0x00,
+    0x85, 0xfb, 0x85, 0xfc, 0xa2, 0x18, 0xa9, 0x00, 0x9d, 0x00, 0xd4, 0xca, 0x10, 0xfa, 0xa9, 0x09,
+    0x8d, 0x05, 0xd4, 0xa9, 0xa4, 0x8d, 0x06, 0xd4, 0xa9, 0x22, 0x8d, 0x0c, 0xd4, 0xa9, 0x88, 0x8d,
+    0x0d, 0xd4, 0xa9, 0x55, 0x8d, 0x13, 0xd4, 0xa9, 0xf9, 0x8d, 0x14, 0xd4, 0xa9, 0x00, 0x8d, 0x02,
+    0xd4, 0xa9, 0x08, 0x8d, 0x03, 0xd4, 0xa9, 0x77, 0x8d, 0x17, 0xd4, 0xa9, 0x1f, 0x8d, 0x18, 0xd4,
+    0xa2, 0x18, 0xa9, 0x00, 0x9d, 0x20, 0xd4, 0xca, 0x10, 0xfa, 0xa9, 0x09, 0x8d, 0x25, 0xd4, 0xa9,
+    0xa4, 0x8d, 0x26, 0xd4, 0xa9, 0x22, 0x8d, 0x2c, 0xd4, 0xa9, 0x88, 0x8d, 0x2d, 0xd4, 0xa9, 0x55,
+    0x8d, 0x33, 0xd4, 0xa9, 0xf9, 0x8d, 0x34, 0xd4, 0xa9, 0x00, 0x8d, 0x22, 0xd4, 0xa9, 0x08, 0x8d,
+    0x23, 0xd4, 0xa9, 0x77, 0x8d, 0x37, 0xd4, 0xa9, 0x1f, 0x8d, 0x38, 0xd4, 0x60, 0xe6, 0xfb, 0xd0,
+    0x02, 0xe6, 0xfc, 0xa5, 0xfb, 0x49, 0x00, 0x8d, 0x00, 0xd4, 0x4a, 0x4a, 0x09, 0x08, 0x8d, 0x01,
+    0xd4, 0xa5, 0xfb, 0x29, 0x0f, 0x8d, 0x03, 0xd4, 0xa5, 0xfb, 0x0a, 0x8d, 0x08, 0xd4, 0xa5, 0xfb,
+    0x49, 0x3c, 0x8d, 0x0f, 0xd4, 0xa5, 0xfb, 0x8d, 0x16, 0xd4, 0xa5, 0xfb, 0x4a, 0x4a, 0x29, 0x30,
+    0x09, 0x0f, 0x8d, 0x18, 0xd4, 0xa5, 0xfc, 0x29, 0x01, 0xf0, 0x12, 0xa9, 0x40, 0x8d, 0x04, 0xd4,
+    0xa9, 0x20, 0x8d, 0x0b, 0xd4, 0xa9, 0x10, 0x8d, 0x12, 0xd4, 0x4c, 0xfc, 0x10, 0xa5, 0xfb, 0x4a,
+    0x4a, 0x4a, 0x4a, 0x29, 0x01, 0x09, 0x40, 0x8d, 0x04, 0xd4, 0xa5, 0xfb, 0x29, 0x20, 0xf0, 0x05,
+    0xa9, 0x21, 0x4c, 0xe9, 0x10, 0xa9, 0x20, 0x8d, 0x0b, 0xd4, 0xa5, 0xfb, 0x29, 0x48, 0xf0, 0x05,
+    0xa9, 0x81, 0x4c, 0xf9, 0x10, 0xa9, 0x15, 0x8d, 0x12, 0xd4, 0xa5, 0xfb, 0x49, 0x55, 0x8d, 0x20,
+    0xd4, 0x4a, 0x4a, 0x09, 0x08, 0x8d, 0x21, 0xd4, 0xa5, 0xfb, 0x29, 0x0f, 0x8d, 0x23, 0xd4, 0xa5,
+    0xfb, 0x0a, 0x8d, 0x28, 0xd4, 0xa5, 0xfb, 0x49, 0x69, 0x8d, 0x2f, 0xd4, 0xa5, 0xfb, 0x8d, 0x36,
+    0xd4, 0xa5, 0xfb, 0x4a, 0x4a, 0x29, 0x30, 0x09, 0x0f, 0x8d, 0x38, 0xd4, 0xa5, 0xfc, 0x29, 0x01,
+    0xf0, 0x12, 0xa9, 0x40, 0x8d, 0x24, 0xd4, 0xa9, 0x20, 0x8d, 0x2b, 0xd4, 0xa9, 0x10, 0x8d, 0x32,
+    0xd4, 0x4c, 0x73, 0x11, 0xa5, 0xfb, 0x4a, 0x4a, 0x4a, 0x4a, 0x29, 0x01, 0x09, 0x40, 0x8d, 0x24,
+    0xd4, 0xa5, 0xfb, 0x29, 0x20, 0xf0, 0x05, 0xa9, 0x21, 0x4c, 0x60, 0x11, 0xa9, 0x20, 0x8d, 0x2b,
+    0xd4, 0xa5, 0xfb, 0x29, 0x48, 0xf0, 0x05, 0xa9, 0x81, 0x4c, 0x70, 0x11, 0xa9, 0x15, 0x8d, 0x32,
+    0xd4, 0x60,
+};
+
+#endif
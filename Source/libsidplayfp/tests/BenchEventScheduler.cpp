@@ -0,0 +1,205 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+/*
+ * Schedule/cancel churn microbenchmark.
+ *
+ * Models the event load of a C64 playing a CIA driven tune:
+ * the CPU runs every cycle and reads a CIA register every few
+ * cycles, which syncs both timers of the chip. Each sync cancels
+ * the cycle skipping event of the timer and ticks it for a cycle
+ * before going back to skipping. The VIC and a few long term
+ * events keep the queue populated.
+ *
+ * Usage: BenchEventScheduler [cycles [access interval]]
+ */
+
+#include "../src/EventScheduler.h"
+#include "../src/EventScheduler.cpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace libsidplayfp;
+
+class Timer;
+
+class SkipEvent final : public Event
+{
+private:
+    Timer &m_timer;
+
+public:
+    SkipEvent(Timer &timer) :
+        Event("Skip timer cycles"),
+        m_timer(timer) {}
+
+    void event() override;
+};
+
+/*
+ * A CIA timer counting down steadily from its latch.
+ */
+class Timer final : public Event
+{
+private:
+    EventScheduler &m_scheduler;
+    SkipEvent m_skip;
+    const unsigned int m_latch;
+    event_clock_t m_underflow;
+
+public:
+    Timer(EventScheduler &scheduler, unsigned int latch) :
+        Event("Timer tick"),
+        m_scheduler(scheduler),
+        m_skip(*this),
+        m_latch(latch),
+        m_underflow(latch) {}
+
+    void event() override
+    {
+        const event_clock_t now = m_scheduler.getTime(EVENT_CLOCK_PHI1);
+        if (now >= m_underflow)
+            m_underflow = now + m_latch;
+        m_scheduler.schedule(m_skip, m_underflow - now, EVENT_CLOCK_PHI1);
+    }
+
+    void sync()
+    {
+        m_scheduler.cancel(m_skip);
+        m_scheduler.cancel(*this);
+        m_scheduler.schedule(*this, 0, EVENT_CLOCK_PHI1);
+    }
+
+    void start() { m_scheduler.schedule(*this, 0, EVENT_CLOCK_PHI1); }
+};
+
+void SkipEvent::event() { m_timer.event(); }
+
+/*
+ * An event rescheduling itself with a fixed period.
+ */
+class Periodic final : public Event
+{
+private:
+    EventScheduler &m_scheduler;
+    const unsigned int m_period;
+    const event_phase_t m_phase;
+
+public:
+    Periodic(EventScheduler &scheduler, unsigned int period, event_phase_t phase) :
+        Event("Periodic"),
+        m_scheduler(scheduler),
+        m_period(period),
+        m_phase(phase) {}
+
+    void event() override { m_scheduler.schedule(*this, m_period, m_phase); }
+
+    void start() { m_scheduler.schedule(*this, 0, m_phase); }
+};
+
+/*
+ * The CPU, accessing the CIA every few cycles.
+ */
+class Cpu final : public Event
+{
+private:
+    EventScheduler &m_scheduler;
+    Timer &m_timerA;
+    Timer &m_timerB;
+    const unsigned int m_interval;
+    unsigned int m_count;
+
+public:
+    unsigned long long accesses;
+
+public:
+    Cpu(EventScheduler &scheduler, Timer &timerA, Timer &timerB, unsigned int interval) :
+        Event("CPU"),
+        m_scheduler(scheduler),
+        m_timerA(timerA),
+        m_timerB(timerB),
+        m_interval(interval),
+        m_count(0),
+        accesses(0) {}
+
+    void event() override
+    {
+        if (++m_count == m_interval)
+        {
+            m_count = 0;
+            accesses++;
+            m_timerA.sync();
+            m_timerB.sync();
+        }
+        m_scheduler.schedule(*this, 1);
+    }
+
+    void start() { m_scheduler.schedule(*this, 0, EVENT_CLOCK_PHI2); }
+};
+
+int main(int argc, char *argv[])
+{
+    const long long cycles = (argc > 1) ? atoll(argv[1]) : 50000000LL;
+    const unsigned int interval = (argc > 2) ? atoi(argv[2]) : 12;
+
+    EventScheduler scheduler;
+    scheduler.reset();
+
+    Timer cia1A(scheduler, 19656);
+    Timer cia1B(scheduler, 0xffff);
+    Timer cia2A(scheduler, 1000);
+    Timer cia2B(scheduler, 0xffff);
+    Periodic vic(scheduler, 63, EVENT_CLOCK_PHI1);
+    Periodic tod1(scheduler, 19656, EVENT_CLOCK_PHI1);
+    Periodic tod2(scheduler, 19656, EVENT_CLOCK_PHI1);
+    Periodic mixer(scheduler, 5000, EVENT_CLOCK_PHI1);
+    Cpu cpu(scheduler, cia1A, cia1B, interval);
+
+    cia1A.start();
+    cia1B.start();
+    cia2A.start();
+    cia2B.start();
+    vic.start();
+    tod1.start();
+    tod2.start();
+    mixer.start();
+    cpu.start();
+
+    unsigned long long events = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (scheduler.getTime(EVENT_CLOCK_PHI2) < cycles)
+    {
+        scheduler.clock();
+        events++;
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double seconds = elapsed.count();
+    printf("cycles: %lld\n", cycles);
+    printf("events: %llu\n", events);
+    printf("cia accesses: %llu\n", cpu.accesses);
+    printf("time: %.3f s\n", seconds);
+    printf("ns/cycle: %.2f\n", seconds * 1e9 / cycles);
+    printf("ns/event: %.2f\n", seconds * 1e9 / events);
+
+    return 0;
+}
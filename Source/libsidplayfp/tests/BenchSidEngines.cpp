@@ -0,0 +1,677 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright (C) 2020 Leandro Nini
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * SID engine benchmark, apart from the 6510/CIA/VIC emulation.
+ *
+ * A tune is played once through the player with a capturing builder,
+ * which records the timestamped register writes of each chip.
+ * The trace is then replayed into reSIDfp and reSID with every
+ * sampling method and a few sample rates, clocking the chips on
+ * their writes and every mixer period as the player does.
+ * Each configuration runs in its own process, and reports the
+ * emulated cycles per second, the time per output sample, the memory
+ * it took and a hash of the output, to check the bit exactness of
+ * optimisations.
+ *
+ * Usage:
+ *   BenchSidEngines <tune> [seconds [song]]
+ *   BenchSidEngines capture <tune> <trace> [seconds [song]]
+ *   BenchSidEngines replay <trace>
+ */
+
+#include "sidplayfp/sidplayfp.h"
+#include "sidplayfp/SidConfig.h"
+#include "sidplayfp/SidTune.h"
+#include "sidplayfp/SidTuneInfo.h"
+#include "sidplayfp/SidInfo.h"
+#include "sidplayfp/sidbuilder.h"
+#include "sidemu.h"
+
+#include "../src/builders/residfp-builder/residfp/SID.h"
+#include "../src/builders/resid-builder/resid/sid.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#  include <sys/resource.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
+
+using namespace libsidplayfp;
+
+/// Cycles between the mixer clocking all the chips, as in the player.
+const unsigned int MIXER_PERIOD = sidemu::OUTPUTBUFFERSIZE;
+
+/*
+ * A register write.
+ */
+typedef struct
+{
+    /// Cycles since the previous write
+    unsigned int delta;
+    unsigned char chip;
+    unsigned char addr;
+    unsigned char value;
+} write_t;
+
+/*
+ * The register writes of a tune.
+ */
+struct Trace
+{
+    double clockFrequency;
+
+    /// Chip models, 6581 or 8580
+    std::vector<int> models;
+
+    std::vector<write_t> writes;
+
+    /// Cycles after the last write
+    unsigned int tail;
+
+    Trace() :
+        clockFrequency(985248.),
+        tail(0) {}
+
+    unsigned long long cycles() const
+    {
+        unsigned long long total = tail;
+        for (std::vector<write_t>::const_iterator it = writes.begin(); it != writes.end(); ++it)
+            total += it->delta;
+        return total;
+    }
+
+    void save(FILE* f) const
+    {
+        fprintf(f, "sidtrace 1 %.1f %u", clockFrequency, static_cast<unsigned int>(models.size()));
+        for (std::vector<int>::const_iterator it = models.begin(); it != models.end(); ++it)
+            fprintf(f, " %d", *it);
+        fprintf(f, "\n");
+
+        for (std::vector<write_t>::const_iterator it = writes.begin(); it != writes.end(); ++it)
+            fprintf(f, "%u %u %u %u\n", it->delta, it->chip, it->addr, it->value);
+
+        fprintf(f, "end %u\n", tail);
+    }
+
+    bool load(FILE* f)
+    {
+        int version;
+        unsigned int chips;
+        bool ok = fscanf(f, "sidtrace %d %lf %u", &version, &clockFrequency, &chips) == 3 && version == 1 && chips > 0;
+
+        models.resize(ok ? chips : 0);
+        for (unsigned int i = 0; ok && i < chips; i++)
+            ok = fscanf(f, "%d", &models[i]) == 1;
+
+        writes.clear();
+        while (ok)
+        {
+            write_t w;
+            unsigned int chip, addr, value;
+            if (fscanf(f, "%u %u %u %u", &w.delta, &chip, &addr, &value) != 4)
+                break;
+            ok = chip < chips && addr < 0x20 && value < 0x100;
+            w.chip = chip;
+            w.addr = addr;
+            w.value = value;
+            writes.push_back(w);
+        }
+
+        return ok && fscanf(f, " end %u", &tail) == 1;
+    }
+
+    bool save(const char* fileName) const
+    {
+        FILE* f = fopen(fileName, "w");
+        if (f == nullptr)
+            return false;
+
+        save(f);
+        return fclose(f) == 0;
+    }
+
+    bool load(const char* fileName)
+    {
+        FILE* f = fopen(fileName, "r");
+        if (f == nullptr)
+            return false;
+
+        const bool ok = load(f);
+        fclose(f);
+        return ok;
+    }
+};
+
+class CaptureBuilder;
+
+/*
+ * A chip which records its writes. Reads are answered by a
+ * reSIDfp chip clocked silently, so the tune runs as usual.
+ */
+class CaptureSid final : public sidemu
+{
+private:
+    CaptureBuilder &m_capture;
+    reSIDfp::SID m_sid;
+    unsigned int m_chip;
+
+public:
+    CaptureSid(CaptureBuilder &builder);
+
+    bool lock(EventScheduler *scheduler) override;
+    void unlock() override;
+
+    void clock() override
+    {
+        const event_clock_t now = eventScheduler->getTime(EVENT_CLOCK_PHI1);
+        m_sid.clockSilent(static_cast<unsigned int>(now - m_accessClk));
+        m_accessClk = now;
+    }
+
+    void voice(unsigned int, bool) override {}
+
+    void model(SidConfig::sid_model_t model, bool) override;
+
+    void sampling(float systemfreq, float, SidConfig::sampling_method_t, bool, SidConfig::sampling_quality_t) override;
+
+    void reset(uint8_t volume) override;
+
+    uint8_t read(uint_least8_t addr) override
+    {
+        clock();
+        return m_sid.read(addr);
+    }
+
+    void write(uint_least8_t addr, uint8_t data) override;
+};
+
+/*
+ * Builds the capturing chips, and collects their writes.
+ */
+class CaptureBuilder final : public sidbuilder
+{
+private:
+    EventScheduler *m_scheduler;
+
+    unsigned int m_locked;
+
+    /// Time of the last write
+    event_clock_t m_last;
+
+public:
+    Trace trace;
+
+public:
+    CaptureBuilder() :
+        sidbuilder("Capture"),
+        m_scheduler(nullptr),
+        m_locked(0),
+        m_last(0) {}
+
+    ~CaptureBuilder() { remove(); }
+
+    unsigned int availDevices() const override { return 0; }
+
+    unsigned int create(unsigned int sids) override
+    {
+        for (unsigned int i = 0; i < sids; i++)
+            sidobjs.insert(new CaptureSid(*this));
+        return sids;
+    }
+
+    const char *credits() const override { return "Register write capture"; }
+
+    void filter(bool) override {}
+
+    unsigned int lockChip(EventScheduler *scheduler)
+    {
+        m_scheduler = scheduler;
+        if (m_locked >= trace.models.size())
+            trace.models.resize(m_locked + 1, 6581);
+        return m_locked++;
+    }
+
+    void unlockChip() { m_locked--; }
+
+    /// The machine restarts, drop what came before.
+    void restart(event_clock_t now)
+    {
+        trace.writes.clear();
+        m_last = now;
+    }
+
+    void record(event_clock_t now, unsigned int chip, uint_least8_t addr, uint8_t data)
+    {
+        write_t w;
+        w.delta = static_cast<unsigned int>(now - m_last);
+        w.chip = chip;
+        w.addr = addr;
+        w.value = data;
+        trace.writes.push_back(w);
+        m_last = now;
+    }
+
+    /// Close the trace at the current time.
+    void finish() { trace.tail = static_cast<unsigned int>(m_scheduler->getTime(EVENT_CLOCK_PHI1) - m_last); }
+};
+
+CaptureSid::CaptureSid(CaptureBuilder &builder) :
+    sidemu(&builder),
+    m_capture(builder),
+    m_chip(0)
+{
+    m_sid.reset();
+}
+
+bool CaptureSid::lock(EventScheduler *scheduler)
+{
+    if (!sidemu::lock(scheduler))
+        return false;
+
+    m_chip = m_capture.lockChip(scheduler);
+    return true;
+}
+
+void CaptureSid::unlock()
+{
+    m_capture.unlockChip();
+    sidemu::unlock();
+}
+
+void CaptureSid::model(SidConfig::sid_model_t model, bool)
+{
+    const bool is8580 = model == SidConfig::MOS8580;
+    m_sid.setChipModel(is8580 ? reSIDfp::MOS8580 : reSIDfp::MOS6581);
+    m_capture.trace.models[m_chip] = is8580 ? 8580 : 6581;
+}
+
+void CaptureSid::sampling(float systemfreq, float, SidConfig::sampling_method_t, bool, SidConfig::sampling_quality_t)
+{
+    m_capture.trace.clockFrequency = systemfreq;
+}
+
+void CaptureSid::reset(uint8_t volume)
+{
+    m_accessClk = eventScheduler != nullptr ? eventScheduler->getTime(EVENT_CLOCK_PHI1) : 0;
+    m_sid.reset();
+    m_sid.write(0x18, volume);
+
+    if (eventScheduler != nullptr)
+    {
+        if (m_chip == 0)
+            m_capture.restart(m_accessClk);
+        m_capture.record(m_accessClk, m_chip, 0x18, volume);
+    }
+}
+
+void CaptureSid::write(uint_least8_t addr, uint8_t data)
+{
+    clock();
+    m_sid.write(addr, data);
+    m_capture.record(m_accessClk, m_chip, addr, data);
+}
+
+/*
+ * Play a tune through the capturing builder.
+ */
+bool capture(const char* fileName, unsigned int seconds, unsigned int song, Trace &trace)
+{
+    SidTune tune(fileName);
+    if (!tune.getStatus())
+    {
+        fprintf(stderr, "%s: %s\n", fileName, tune.statusString());
+        return false;
+    }
+    tune.selectSong(song);
+
+    sidplayfp engine;
+    CaptureBuilder builder;
+    builder.create(engine.info().maxsids());
+
+    SidConfig cfg;
+    cfg.sidEmulation = &builder;
+    // The same trace on every run
+    cfg.powerOnDelay = 0;
+    if (!engine.config(cfg) || !engine.load(&tune))
+    {
+        fprintf(stderr, "%s: %s\n", fileName, engine.error());
+        return false;
+    }
+
+    while (engine.time() < seconds)
+    {
+        engine.play(nullptr, 0);
+        if (!engine.isPlaying())
+        {
+            fprintf(stderr, "%s: %s\n", fileName, engine.error());
+            return false;
+        }
+    }
+
+    builder.finish();
+    trace = builder.trace;
+
+    engine.load(nullptr);
+    return true;
+}
+
+/*
+ * A chip of the emulation under test.
+ */
+class Chip
+{
+public:
+    virtual ~Chip() {}
+
+    virtual void write(unsigned char addr, unsigned char value) = 0;
+
+    /// Clock the chip and return the number of samples output.
+    virtual unsigned int clock(unsigned int cycles, short* buf) = 0;
+};
+
+class ReSIDfpChip final : public Chip
+{
+private:
+    reSIDfp::SID m_sid;
+
+public:
+    ReSIDfpChip(int model, double clockFrequency, reSIDfp::SamplingMethod method, double rate)
+    {
+        m_sid.setChipModel(model == 8580 ? reSIDfp::MOS8580 : reSIDfp::MOS6581);
+        m_sid.setSamplingParameters(clockFrequency, method, rate, rate > 44000. ? 20000. : 9. * rate / 20.);
+        m_sid.reset();
+    }
+
+    void write(unsigned char addr, unsigned char value) override { m_sid.write(addr, value); }
+
+    unsigned int clock(unsigned int cycles, short* buf) override { return m_sid.clock(cycles, buf); }
+};
+
+class ReSIDChip final : public Chip
+{
+private:
+    reSID::SID m_sid;
+
+public:
+    ReSIDChip(int model, double clockFrequency, reSID::sampling_method method, double rate)
+    {
+        m_sid.set_chip_model(model == 8580 ? reSID::MOS8580 : reSID::MOS6581);
+        m_sid.set_sampling_parameters(clockFrequency, method, rate);
+        m_sid.reset();
+    }
+
+    void write(unsigned char addr, unsigned char value) override { m_sid.write(addr, value); }
+
+    unsigned int clock(unsigned int cycles, short* buf) override
+    {
+        reSID::cycle_count delta = cycles;
+        unsigned int n = 0;
+        while (delta > 0)
+            n += m_sid.clock(delta, buf + n, MIXER_PERIOD - n);
+        return n;
+    }
+};
+
+/*
+ * An engine setting under test.
+ */
+typedef struct
+{
+    const char* engine;
+    const char* method;
+    int id;
+} setting_t;
+
+const setting_t settings[] =
+{
+    { "residfp", "decimate", reSIDfp::DECIMATE },
+    { "residfp", "resample", reSIDfp::RESAMPLE },
+    { "resid", "fast", reSID::SAMPLE_FAST },
+    { "resid", "interpolate", reSID::SAMPLE_INTERPOLATE },
+    { "resid", "resample", reSID::SAMPLE_RESAMPLE },
+    { "resid", "resample_fastmem", reSID::SAMPLE_RESAMPLE_FASTMEM },
+};
+
+const double rates[] = { 22050., 44100., 48000., 96000. };
+
+Chip* createChip(const setting_t &setting, int model, double clockFrequency, double rate)
+{
+    if (strcmp(setting.engine, "residfp") == 0)
+        return new ReSIDfpChip(model, clockFrequency, static_cast<reSIDfp::SamplingMethod>(setting.id), rate);
+    return new ReSIDChip(model, clockFrequency, static_cast<reSID::sampling_method>(setting.id), rate);
+}
+
+/*
+ * The output of the chips, hashed.
+ */
+typedef struct
+{
+    std::vector<short> buf;
+    unsigned long long samples;
+    unsigned int hash;
+} output_t;
+
+/*
+ * Clock a chip up to the time of the trace.
+ */
+static void catchUp(Chip &chip, unsigned long long &pending, output_t &output)
+{
+    while (pending > 0)
+    {
+        const unsigned int cycles = static_cast<unsigned int>(std::min<unsigned long long>(pending, MIXER_PERIOD));
+        const unsigned int n = chip.clock(cycles, &output.buf[0]);
+        for (unsigned int i = 0; i < n; i++)
+            output.hash = (output.hash ^ static_cast<unsigned short>(output.buf[i])) * 16777619u;
+        output.samples += n;
+        pending -= cycles;
+    }
+}
+
+long peakKb()
+{
+#ifndef _WIN32
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Replay the trace into the chips and print the figures.
+ */
+void replay(const Trace &trace, const setting_t &setting, double rate)
+{
+    const long startKb = peakKb();
+
+    const unsigned int chips = trace.models.size();
+    std::vector<std::unique_ptr<Chip>> chip(chips);
+    for (unsigned int i = 0; i < chips; i++)
+        chip[i].reset(createChip(setting, trace.models[i], trace.clockFrequency, rate));
+
+    std::vector<unsigned long long> pending(chips, 0);
+    output_t output;
+    output.buf.resize(MIXER_PERIOD);
+    output.samples = 0;
+    output.hash = 2166136261u;
+    unsigned int mixer = 0;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (unsigned int w = 0; w <= trace.writes.size(); w++)
+    {
+        unsigned int delta = w < trace.writes.size() ? trace.writes[w].delta : trace.tail;
+
+        // The mixer clocks all the chips periodically
+        while (mixer + delta >= MIXER_PERIOD)
+        {
+            const unsigned int step = MIXER_PERIOD - mixer;
+            for (unsigned int i = 0; i < chips; i++)
+            {
+                pending[i] += step;
+                catchUp(*chip[i], pending[i], output);
+            }
+            delta -= step;
+            mixer = 0;
+        }
+
+        mixer += delta;
+        for (unsigned int i = 0; i < chips; i++)
+            pending[i] += delta;
+
+        if (w < trace.writes.size())
+        {
+            const write_t &write = trace.writes[w];
+            catchUp(*chip[write.chip], pending[write.chip], output);
+            chip[write.chip]->write(write.addr, write.value);
+        }
+    }
+
+    for (unsigned int i = 0; i < chips; i++)
+        catchUp(*chip[i], pending[i], output);
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const double seconds = elapsed.count();
+    const double cycles = static_cast<double>(trace.cycles()) * chips;
+
+    printf("%-8s %-17s %6.0f %12.2f %10.1f %10ld %08x\n",
+        setting.engine, setting.method, rate,
+        cycles / seconds / 1e6,
+        output.samples > 0 ? seconds * 1e9 / output.samples : 0.,
+        peakKb() - startKb,
+        output.hash);
+    fflush(stdout);
+}
+
+void replayAll(const Trace &trace)
+{
+    printf("clock %.0f Hz, %u chip(s), %llu cycles, %u writes\n",
+        trace.clockFrequency, static_cast<unsigned int>(trace.models.size()), trace.cycles(),
+        static_cast<unsigned int>(trace.writes.size()));
+    printf("%-8s %-17s %6s %12s %10s %10s %8s\n", "engine", "method", "rate", "Mcycles/s", "ns/sample", "memory kB", "hash");
+    fflush(stdout);
+
+    for (unsigned int s = 0; s < sizeof(settings) / sizeof(settings[0]); s++)
+    {
+        for (unsigned int r = 0; r < sizeof(rates) / sizeof(rates[0]); r++)
+        {
+#ifndef _WIN32
+            // A process of its own, for the memory figures
+            const pid_t pid = fork();
+            if (pid == 0)
+            {
+                replay(trace, settings[s], rates[r]);
+                _exit(0);
+            }
+            if (pid > 0)
+            {
+                int status;
+                waitpid(pid, &status, 0);
+                continue;
+            }
+#endif
+            replay(trace, settings[s], rates[r]);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Trace trace;
+
+    if (argc >= 3 && strcmp(argv[1], "replay") == 0)
+    {
+        if (!trace.load(argv[2]))
+        {
+            fprintf(stderr, "%s: not a valid trace\n", argv[2]);
+            return 1;
+        }
+        replayAll(trace);
+        return 0;
+    }
+
+    if (argc >= 4 && strcmp(argv[1], "capture") == 0)
+    {
+        const unsigned int seconds = (argc > 4) ? atoi(argv[4]) : 60;
+        const unsigned int song = (argc > 5) ? atoi(argv[5]) : 0;
+        if (!capture(argv[2], seconds, song, trace))
+            return 1;
+        if (!trace.save(argv[3]))
+        {
+            fprintf(stderr, "%s: cannot write the trace\n", argv[3]);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (argc >= 2 && strcmp(argv[1], "capture") != 0 && strcmp(argv[1], "replay") != 0)
+    {
+        const unsigned int seconds = (argc > 2) ? atoi(argv[2]) : 60;
+        const unsigned int song = (argc > 3) ? atoi(argv[3]) : 0;
+#ifndef _WIN32
+        // Capture in a process of its own, so that the tables
+        // it builds are not counted in the memory figures
+        FILE* f = tmpfile();
+        if (f == nullptr)
+            return 1;
+        fflush(stdout);
+        const pid_t pid = fork();
+        if (pid == 0)
+        {
+            const bool ok = capture(argv[1], seconds, song, trace);
+            if (ok)
+                trace.save(f);
+            fflush(f);
+            _exit(ok ? 0 : 1);
+        }
+        int status = 1;
+        if (pid > 0)
+            waitpid(pid, &status, 0);
+        rewind(f);
+        const bool ok = status == 0 && trace.load(f);
+        fclose(f);
+        if (!ok)
+            return 1;
+#else
+        if (!capture(argv[1], seconds, song, trace))
+            return 1;
+#endif
+        replayAll(trace);
+        return 0;
+    }
+
+    fprintf(stderr, "Usage:\n");
+    fprintf(stderr, "  %s <tune> [seconds [song]]\n", argv[0]);
+    fprintf(stderr, "  %s capture <tune> <trace> [seconds [song]]\n", argv[0]);
+    fprintf(stderr, "  %s replay <trace>\n", argv[0]);
+    return 1;
+}
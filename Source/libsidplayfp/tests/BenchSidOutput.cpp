@@ -0,0 +1,127 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright (C) 2020 Leandro Nini
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * 16 bit versus high resolution output microbenchmark.
+ *
+ * Renders the same register writes with the clipped 16 bit output
+ * and with the unclipped high resolution one, for each chip model
+ * and a few sample rates, and reports the time per output sample.
+ *
+ * Usage: BenchSidOutput [seconds]
+ */
+
+#include "../src/builders/residfp-builder/residfp/SID.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace reSIDfp;
+
+const double CLOCK = 985248.;
+
+/// Cycles between register updates, a PAL frame.
+const unsigned int FRAME = 19656;
+
+/// Cycles clocked at once, as between two chip accesses.
+const unsigned int CHUNK = 500;
+
+/*
+ * Three voices and the filter busy all the time,
+ * with the notes changing every frame.
+ */
+void play(SID &sid, unsigned int frame)
+{
+    static const unsigned char controls[3] = { 0x21, 0x41, 0x81 };
+
+    for (int v = 0; v < 3; v++)
+    {
+        const unsigned int freq = 0x1000 + ((frame * 7 + v * 13) % 32) * 0x200;
+        sid.write(v * 7 + 0, freq & 0xff);
+        sid.write(v * 7 + 1, freq >> 8);
+        sid.write(v * 7 + 2, 0x00);
+        sid.write(v * 7 + 3, 0x08);
+        sid.write(v * 7 + 5, 0x00);
+        sid.write(v * 7 + 6, 0xf0);
+        sid.write(v * 7 + 4, controls[v]);
+    }
+
+    sid.write(0x15, 0x00);
+    sid.write(0x16, 0x40 + (frame % 64));
+    sid.write(0x17, 0xf3);
+    sid.write(0x18, 0x1f);
+}
+
+template<typename T>
+double run(ChipModel model, double rate, bool highResolution, unsigned int seconds, unsigned long long &samples)
+{
+    SID sid;
+    sid.setChipModel(model);
+    sid.setSamplingParameters(CLOCK, RESAMPLE, rate, 20000., 16, highResolution);
+    sid.reset();
+
+    std::vector<T> buf(CHUNK);
+
+    const unsigned int frames = static_cast<unsigned int>(seconds * CLOCK / FRAME);
+
+    samples = 0;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int f = 0; f < frames; f++)
+    {
+        play(sid, f);
+        for (unsigned int c = 0; c < FRAME; c += CHUNK)
+        {
+            samples += sid.clock(CHUNK, &buf[0]);
+        }
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    return elapsed.count();
+}
+
+int main(int argc, char *argv[])
+{
+    const unsigned int seconds = (argc > 1) ? atoi(argv[1]) : 10;
+
+    static const ChipModel models[2] = { MOS6581, MOS8580 };
+    static const double rates[3] = { 44100., 48000., 96000. };
+
+    printf("%-8s %8s %14s %14s %14s %8s\n", "model", "rate", "int16 ns", "int32 ns", "int32 hr ns", "hr/16");
+
+    for (int m = 0; m < 2; m++)
+    {
+        for (int r = 0; r < 3; r++)
+        {
+            unsigned long long samples;
+            const double t16 = run<short>(models[m], rates[r], false, seconds, samples);
+            const double t32 = run<int>(models[m], rates[r], false, seconds, samples);
+            const double tHr = run<int>(models[m], rates[r], true, seconds, samples);
+
+            const double scale = 1e9 / samples;
+            printf("%-8s %8.0f %14.1f %14.1f %14.1f %8.3f\n",
+                models[m] == MOS6581 ? "6581" : "8580", rates[r],
+                t16 * scale, t32 * scale, tHr * scale, tHr / t16);
+        }
+    }
+
+    return 0;
+}
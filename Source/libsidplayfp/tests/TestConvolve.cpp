@@ -0,0 +1,187 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include "../src/builders/residfp-builder/residfp/resample/convolve.cpp"
+
+#include <string>
+#include <vector>
+
+using namespace UnitTest;
+using namespace reSIDfp;
+
+/// Longest filter, the size of the SincResampler ring buffer.
+const int MAX_LENGTH = 2047;
+
+/*
+ * Random samples over the full range, and coefficients small enough
+ * for the longest sum to fit in 32 bits.
+ */
+struct Data
+{
+    std::vector<short> samples;
+    std::vector<int> wideSamples;
+    std::vector<short> fir;
+
+    Data() :
+        samples(MAX_LENGTH + 64),
+        wideSamples(MAX_LENGTH + 64),
+        fir(MAX_LENGTH + 64)
+    {
+        unsigned int seed = 12345;
+        for (unsigned int i = 0; i < samples.size(); i++)
+        {
+            seed = seed * 1103515245 + 12345;
+            samples[i] = static_cast<short>(seed >> 16);
+            // Unclipped samples go up to twice the 16 bit range
+            wideSamples[i] = static_cast<int>(seed >> 15) - 65536;
+            seed = seed * 1103515245 + 12345;
+            fir[i] = static_cast<short>(static_cast<int>((seed >> 16) % 64) - 32);
+        }
+    }
+};
+
+template<typename T>
+long long reference(const T* a, const short* b, int length)
+{
+    long long sum = 0;
+    for (int i = 0; i < length; i++)
+        sum += static_cast<long long>(a[i]) * b[i];
+    return sum;
+}
+
+SUITE(Convolve)
+{
+
+TEST(TestScalarLast)
+{
+    CHECK(convolveKernelCount > 0);
+    CHECK_EQUAL(std::string("scalar"), convolveKernels[convolveKernelCount - 1].name);
+}
+
+TEST(TestKernels)
+{
+    Data data;
+
+    for (unsigned int k = 0; k < convolveKernelCount; k++)
+    {
+        const convolve_kernel_t &kernel = convolveKernels[k];
+        if (!kernel.supported())
+            continue;
+
+        // Every tail length, and misaligned buffers
+        for (int length = 0; length <= 130; length++)
+        {
+            for (int offset = 0; offset < 32; offset += 3)
+            {
+                const short* a = &data.samples[offset];
+                const short* b = &data.fir[(offset * 7) & 31];
+                CHECK_EQUAL(reference(a, b, length), kernel.dot(a, b, length));
+            }
+        }
+
+        for (int length = MAX_LENGTH - 40; length <= MAX_LENGTH; length++)
+        {
+            CHECK_EQUAL(reference(&data.samples[1], &data.fir[0], length), kernel.dot(&data.samples[1], &data.fir[0], length));
+        }
+    }
+}
+
+TEST(TestWideKernels)
+{
+    Data data;
+
+    for (unsigned int k = 0; k < convolveKernelCount; k++)
+    {
+        const convolve_kernel_t &kernel = convolveKernels[k];
+        if (!kernel.supported())
+            continue;
+
+        for (int length = 0; length <= 130; length++)
+        {
+            for (int offset = 0; offset < 32; offset += 3)
+            {
+                const int* a = &data.wideSamples[offset];
+                const short* b = &data.fir[(offset * 7) & 31];
+                CHECK_EQUAL(reference(a, b, length), kernel.dotWide(a, b, length));
+            }
+        }
+
+        for (int length = MAX_LENGTH - 40; length <= MAX_LENGTH; length++)
+        {
+            CHECK_EQUAL(reference(&data.wideSamples[1], &data.fir[0], length), kernel.dotWide(&data.wideSamples[1], &data.fir[0], length));
+        }
+    }
+}
+
+/*
+ * Unclipped samples at full scale, whose sums need more than 32 bits:
+ * DC, and alternating with the sign of the coefficients.
+ */
+TEST(TestWideKernelsFullScale)
+{
+    std::vector<int> dc(MAX_LENGTH, 65536);
+    std::vector<int> alternating(MAX_LENGTH);
+    std::vector<short> positive(MAX_LENGTH, 32767);
+    std::vector<short> signs(MAX_LENGTH);
+    for (int i = 0; i < MAX_LENGTH; i++)
+    {
+        alternating[i] = (i & 1) ? -65536 : 65536;
+        signs[i] = (i & 1) ? -32768 : 32767;
+    }
+
+    const int lengths[] = { 3, 17, 64, MAX_LENGTH - 1, MAX_LENGTH };
+
+    for (unsigned int k = 0; k < convolveKernelCount; k++)
+    {
+        const convolve_kernel_t &kernel = convolveKernels[k];
+        if (!kernel.supported())
+            continue;
+
+        for (unsigned int i = 0; i < 5; i++)
+        {
+            const int length = lengths[i];
+            CHECK_EQUAL(reference(&dc[0], &positive[0], length), kernel.dotWide(&dc[0], &positive[0], length));
+            CHECK_EQUAL(reference(&alternating[0], &signs[0], length), kernel.dotWide(&alternating[0], &signs[0], length));
+        }
+    }
+
+    // A filter with unity gain passes full scale DC
+    const short unity[] = { 8192, 8192, 8192, 8192 };
+    CHECK_EQUAL(65536, convolve(&dc[0], unity, 4));
+}
+
+TEST(TestConvolve)
+{
+    Data data;
+
+    for (int length = 1000; length < 1010; length++)
+    {
+        const int expected = static_cast<int>((reference(&data.samples[0], &data.fir[0], length) + (1 << 14)) >> 15);
+        CHECK_EQUAL(expected, convolve(&data.samples[0], &data.fir[0], length));
+
+        const int expectedWide = static_cast<int>((reference(&data.wideSamples[0], &data.fir[0], length) + (1 << 14)) >> 15);
+        CHECK_EQUAL(expectedWide, convolve(&data.wideSamples[0], &data.fir[0], length));
+    }
+}
+
+}
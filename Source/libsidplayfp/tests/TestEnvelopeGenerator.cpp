@@ -143,4 +143,119 @@ TEST_FIXTURE(TestFixture, TestFlip00toFF)
     CHECK_EQUAL(0xff, (int)generator.readENV());
 }
 
+TEST(TestClockCycles)
+{
+    // Clocking many cycles at once must match clocking them one by one,
+    // across attack, decay, sustain, release and the frozen state.
+
+    reSIDfp::EnvelopeGenerator single;
+    reSIDfp::EnvelopeGenerator multi;
+    single.reset();
+    multi.reset();
+
+    unsigned int seed = 1;
+    for (int step = 0; step < 400; step++)
+    {
+        seed = seed * 1103515245 + 12345;
+        const unsigned char value = static_cast<unsigned char>(seed >> 16);
+
+        switch ((seed >> 28) & 3)
+        {
+        case 0:
+            single.writeATTACK_DECAY(value);
+            multi.writeATTACK_DECAY(value);
+            break;
+        case 1:
+            single.writeSUSTAIN_RELEASE(value);
+            multi.writeSUSTAIN_RELEASE(value);
+            break;
+        default:
+            single.writeCONTROL_REG(value & 1);
+            multi.writeCONTROL_REG(value & 1);
+            break;
+        }
+
+        seed = seed * 1103515245 + 12345;
+        const unsigned int cycles = (seed >> 16) % 20000;
+
+        for (unsigned int i = 0; i < cycles; i++)
+            single.clock();
+        multi.clock(cycles);
+
+        CHECK_EQUAL(single.lfsr, multi.lfsr);
+        CHECK_EQUAL((int)single.envelope_counter, (int)multi.envelope_counter);
+        CHECK_EQUAL((int)single.readENV(), (int)multi.readENV());
+        CHECK_EQUAL(single.exponential_counter, multi.exponential_counter);
+        CHECK_EQUAL(single.state, multi.state);
+        CHECK_EQUAL(single.resetLfsr, multi.resetLfsr);
+    }
+}
+
+TEST(TestIdleCycles)
+{
+    reSIDfp::EnvelopeGenerator generator;
+    generator.reset();
+    generator.writeSUSTAIN_RELEASE(0x0f);
+
+    // The first cycles after reset restart the rate counter
+    // and step the envelope
+    CHECK_EQUAL(0u, generator.idleCycles());
+    for (int i = 0; i < 10 && generator.idleCycles() == 0; i++)
+        generator.clock();
+
+    // Count down to the comparison value, one step per cycle
+    const unsigned int idle = generator.idleCycles();
+    CHECK(idle > 0);
+    for (unsigned int i = 0; i < idle; i++)
+    {
+        CHECK(generator.lfsr != generator.rate);
+        generator.clock();
+    }
+    CHECK_EQUAL(generator.rate, generator.lfsr);
+    CHECK_EQUAL(0u, generator.idleCycles());
+}
+
+
+TEST(TestFrozenCycles)
+{
+    // Released to zero the counter is frozen, while the rate counter
+    // keeps looping up to the comparison value.
+
+    for (unsigned int release = 0; release < 16; release++)
+    {
+        reSIDfp::EnvelopeGenerator single;
+        reSIDfp::EnvelopeGenerator multi;
+
+        reSIDfp::EnvelopeGenerator* generators[] = { &single, &multi };
+        for (unsigned int g = 0; g < 2; g++)
+        {
+            generators[g]->reset();
+            generators[g]->writeSUSTAIN_RELEASE(release);
+            while (generators[g]->envelope_counter != 0)
+                generators[g]->clock();
+        }
+
+        // The exponential counter period is updated at the next rate counter match
+        for (int i = 0; i < 0x10000 && !multi.isFrozen(); i++)
+        {
+            single.clock();
+            multi.clock();
+        }
+        CHECK(multi.isFrozen());
+        CHECK_EQUAL(~0u, multi.idleCycles());
+
+        const unsigned int cycles[] = { 1, 2, 3, 10, 0x7f, 0x80, 1000, 33000, 100000 };
+        for (unsigned int c = 0; c < 9; c++)
+        {
+            for (unsigned int i = 0; i < cycles[c]; i++)
+                single.clock();
+            multi.clock(cycles[c]);
+
+            CHECK_EQUAL(single.lfsr, multi.lfsr);
+            CHECK_EQUAL(single.resetLfsr, multi.resetLfsr);
+            CHECK_EQUAL((int)single.readENV(), (int)multi.readENV());
+        }
+    }
+}
+
 }
@@ -0,0 +1,157 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include "../src/EventScheduler.h"
+#include "../src/EventScheduler.cpp"
+
+#include <string>
+
+using namespace UnitTest;
+using namespace libsidplayfp;
+
+/*
+ * Append its tag to a log when fired.
+ */
+class testEvent final : public Event
+{
+private:
+    std::string &m_log;
+    const char m_tag;
+
+public:
+    testEvent(std::string &log, char tag) :
+        Event("Test event"),
+        m_log(log),
+        m_tag(tag) {}
+
+    void event() override { m_log += m_tag; }
+};
+
+/*
+ * Run all the pending events.
+ */
+void runAll(EventScheduler &scheduler, Event &sentinel)
+{
+    while (scheduler.isPending(sentinel))
+        scheduler.clock();
+}
+
+SUITE(EventScheduler)
+{
+
+struct TestFixture
+{
+    // Test setup
+    TestFixture() :
+        a(log, 'a'),
+        b(log, 'b'),
+        c(log, 'c'),
+        end(log, '.')
+    {
+        scheduler.reset();
+    }
+
+    EventScheduler scheduler;
+    std::string log;
+    testEvent a;
+    testEvent b;
+    testEvent c;
+    testEvent end;
+};
+
+TEST_FIXTURE(TestFixture, TestOrder)
+{
+    scheduler.schedule(c, 3, EVENT_CLOCK_PHI1);
+    scheduler.schedule(a, 1, EVENT_CLOCK_PHI1);
+    scheduler.schedule(b, 1, EVENT_CLOCK_PHI1);
+    scheduler.schedule(end, 10, EVENT_CLOCK_PHI1);
+
+    runAll(scheduler, end);
+
+    // same time events fire in scheduling order
+    CHECK_EQUAL("abc.", log);
+}
+
+TEST_FIXTURE(TestFixture, TestCancel)
+{
+    scheduler.schedule(a, 1, EVENT_CLOCK_PHI1);
+    scheduler.schedule(b, 2, EVENT_CLOCK_PHI1);
+    scheduler.schedule(c, 3, EVENT_CLOCK_PHI1);
+    scheduler.schedule(end, 10, EVENT_CLOCK_PHI1);
+
+    CHECK(scheduler.isPending(b));
+    scheduler.cancel(b);
+    CHECK(!scheduler.isPending(b));
+
+    // cancelling twice is harmless
+    scheduler.cancel(b);
+
+    scheduler.cancel(a);
+    scheduler.cancel(end);
+    scheduler.schedule(end, 10, EVENT_CLOCK_PHI1);
+
+    runAll(scheduler, end);
+
+    CHECK_EQUAL("c.", log);
+}
+
+TEST_FIXTURE(TestFixture, TestReschedule)
+{
+    scheduler.schedule(a, 1, EVENT_CLOCK_PHI1);
+    scheduler.schedule(b, 2, EVENT_CLOCK_PHI1);
+    scheduler.schedule(end, 10, EVENT_CLOCK_PHI1);
+
+    // scheduling a pending event moves it
+    scheduler.schedule(a, 3, EVENT_CLOCK_PHI1);
+
+    runAll(scheduler, end);
+
+    CHECK_EQUAL("ba.", log);
+}
+
+TEST_FIXTURE(TestFixture, TestPendingAfterFire)
+{
+    scheduler.schedule(a, 1, EVENT_CLOCK_PHI1);
+    scheduler.clock();
+
+    CHECK_EQUAL("a", log);
+    CHECK(!scheduler.isPending(a));
+}
+
+TEST_FIXTURE(TestFixture, TestReset)
+{
+    scheduler.schedule(a, 1, EVENT_CLOCK_PHI1);
+    scheduler.schedule(b, 2, EVENT_CLOCK_PHI1);
+
+    scheduler.reset();
+
+    CHECK(!scheduler.isPending(a));
+    CHECK(!scheduler.isPending(b));
+
+    scheduler.schedule(end, 1, EVENT_CLOCK_PHI1);
+    runAll(scheduler, end);
+
+    CHECK_EQUAL(".", log);
+}
+
+}
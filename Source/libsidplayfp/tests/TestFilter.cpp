@@ -0,0 +1,104 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include "../src/builders/residfp-builder/residfp/Filter6581.h"
+#include "../src/builders/residfp-builder/residfp/Filter8580.h"
+
+#include <vector>
+
+using namespace UnitTest;
+using namespace reSIDfp;
+
+const unsigned int CYCLES = 300;
+
+/// Voice outputs in the range of Voice::output().
+std::vector<int> voice(unsigned int seed)
+{
+    std::vector<int> samples(CYCLES);
+    for (unsigned int i = 0; i < CYCLES; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        samples[i] = static_cast<int>((seed >> 12) % (4096 * 255)) - 2048 * 255;
+    }
+    return samples;
+}
+
+/*
+ * Check that the block clocking gives the same output as clocking
+ * each cycle, for every routing of the voices and of the outputs.
+ */
+void checkRoutings(Filter &single, Filter &block)
+{
+    const std::vector<int> v1 = voice(1);
+    const std::vector<int> v2 = voice(2);
+    const std::vector<int> v3 = voice(3);
+
+    Filter* filters[] = { &single, &block };
+    for (unsigned int f = 0; f < 2; f++)
+    {
+        filters[f]->reset();
+        filters[f]->input(1000);
+        filters[f]->writeFC_LO(0x05);
+        filters[f]->writeFC_HI(0x40);
+    }
+
+    for (unsigned int filt = 0; filt < 16; filt++)
+    {
+        for (unsigned int mode = 0; mode < 16; mode++)
+        {
+            for (unsigned int f = 0; f < 2; f++)
+            {
+                filters[f]->writeRES_FILT(0x80 | filt);
+                filters[f]->writeMODE_VOL((mode << 4) | 0x0f);
+            }
+
+            std::vector<unsigned short> expected(CYCLES);
+            for (unsigned int i = 0; i < CYCLES; i++)
+                expected[i] = single.clock(v1[i], v2[i], v3[i]);
+
+            std::vector<unsigned short> actual(CYCLES);
+            block.clock(&v1[0], &v2[0], &v3[0], &actual[0], CYCLES);
+
+            CHECK_ARRAY_EQUAL(&expected[0], &actual[0], CYCLES);
+        }
+    }
+}
+
+SUITE(Filter)
+{
+
+TEST(TestBlock6581)
+{
+    Filter6581 single;
+    Filter6581 block;
+    checkRoutings(single, block);
+}
+
+TEST(TestBlock8580)
+{
+    Filter8580 single;
+    Filter8580 block;
+    checkRoutings(single, block);
+}
+
+}
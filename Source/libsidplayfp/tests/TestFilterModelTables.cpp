@@ -0,0 +1,304 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include "../src/builders/residfp-builder/residfp/version.cc"
+#include "../src/builders/residfp-builder/residfp/TableCache.cpp"
+#include "../src/builders/residfp-builder/residfp/FilterModelTables.h"
+#include "../src/builders/residfp-builder/residfp/FilterModelTables.cpp"
+#include "../src/builders/residfp-builder/residfp/TableImage.cpp"
+#include "../src/builders/residfp-builder/residfp/OpAmp.cpp"
+#include "../src/builders/residfp-builder/residfp/Spline.cpp"
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+
+#include <dirent.h>
+#include <unistd.h>
+
+using namespace UnitTest;
+using namespace reSIDfp;
+
+const unsigned int OPAMP_SIZE = 33;
+
+const Spline::Point opamp_voltage[OPAMP_SIZE] =
+{
+  {  0.81, 10.31 },  // Approximate start of actual range
+  {  2.40, 10.31 },
+  {  2.60, 10.30 },
+  {  2.70, 10.29 },
+  {  2.80, 10.26 },
+  {  2.90, 10.17 },
+  {  3.00, 10.04 },
+  {  3.10,  9.83 },
+  {  3.20,  9.58 },
+  {  3.30,  9.32 },
+  {  3.50,  8.69 },
+  {  3.70,  8.00 },
+  {  4.00,  6.89 },
+  {  4.40,  5.21 },
+  {  4.54,  4.54 },  // Working point (vi = vo)
+  {  4.60,  4.19 },
+  {  4.80,  3.00 },
+  {  4.90,  2.30 },  // Change of curvature
+  {  4.95,  2.03 },
+  {  5.00,  1.88 },
+  {  5.05,  1.77 },
+  {  5.10,  1.69 },
+  {  5.20,  1.58 },
+  {  5.40,  1.44 },
+  {  5.60,  1.33 },
+  {  5.80,  1.26 },
+  {  6.00,  1.21 },
+  {  6.40,  1.12 },
+  {  7.00,  1.02 },
+  {  7.50,  0.97 },
+  {  8.50,  0.89 },
+  { 10.00,  0.81 },
+  { 10.31,  0.81 },  // Approximate end of actual range
+};
+
+const double Vddt = 12.18 - 1.31;
+const double vmin = 0.81;
+const double N16 = 65535. / (Vddt - vmin);
+
+const unsigned int SIZE = 1 << 12;
+
+/*
+ * Two tables filled with a model.
+ */
+struct Model
+{
+    unsigned short *summer;
+    unsigned short *gain;
+    FilterModelTables tables;
+
+    Model() :
+        tables(opamp_voltage, OPAMP_SIZE, Vddt, vmin, N16)
+    {
+        tables.add(&summer, SIZE, 2, 2);
+        tables.add(&gain, SIZE, 0.5, 1);
+    }
+};
+
+SUITE(FilterModelTables)
+{
+
+TEST(TestRoundTrip)
+{
+    Model solved;
+    CHECK(!solved.tables.build(nullptr, 0));
+
+    std::vector<unsigned char> image;
+    solved.tables.encode(image);
+
+    Model decoded;
+    CHECK(decoded.tables.build(&image[0], image.size()));
+    CHECK_ARRAY_EQUAL(solved.summer, decoded.summer, SIZE);
+    CHECK_ARRAY_EQUAL(solved.gain, decoded.gain, SIZE);
+}
+
+TEST(TestCorruptImage)
+{
+    Model solved;
+    solved.tables.build(nullptr, 0);
+
+    std::vector<unsigned char> image;
+    solved.tables.encode(image);
+    image[image.size() / 2] ^= 1;
+
+    Model decoded;
+    CHECK(!decoded.tables.build(&image[0], image.size()));
+    CHECK_ARRAY_EQUAL(solved.summer, decoded.summer, SIZE);
+    CHECK_ARRAY_EQUAL(solved.gain, decoded.gain, SIZE);
+}
+
+TEST(TestWrongEntry)
+{
+    Model solved;
+    solved.tables.build(nullptr, 0);
+
+    // An image of the same model whose tables differ near the end,
+    // as if baked on a host with a different floating point
+    Model wrong;
+    wrong.tables.build(nullptr, 0);
+    wrong.summer[SIZE - 1]++;
+    wrong.gain[SIZE - 1]++;
+
+    std::vector<unsigned char> image;
+    wrong.tables.encode(image);
+
+    Model decoded;
+    CHECK(!decoded.tables.build(&image[0], image.size()));
+    CHECK_ARRAY_EQUAL(solved.summer, decoded.summer, SIZE);
+    CHECK_ARRAY_EQUAL(solved.gain, decoded.gain, SIZE);
+}
+
+TEST(TestOtherModel)
+{
+    Model solved;
+    solved.tables.build(nullptr, 0);
+
+    std::vector<unsigned char> image;
+    solved.tables.encode(image);
+
+    unsigned short *summer;
+    unsigned short *gain;
+    FilterModelTables other(opamp_voltage, OPAMP_SIZE, Vddt, vmin, N16);
+    other.add(&summer, SIZE, 3, 2);
+    other.add(&gain, SIZE, 0.5, 1);
+    CHECK(!other.build(&image[0], image.size()));
+}
+
+TEST(TestTruncatedImage)
+{
+    Model solved;
+    solved.tables.build(nullptr, 0);
+
+    std::vector<unsigned char> image;
+    solved.tables.encode(image);
+    image.resize(image.size() - 1);
+
+    Model decoded;
+    CHECK(!decoded.tables.build(&image[0], image.size()));
+}
+
+static void removeDirectory(const char *dir)
+{
+    DIR *d = opendir(dir);
+    for (dirent *e = readdir(d); e != nullptr; e = readdir(d))
+    {
+        if (e->d_name[0] != '.')
+            unlink((std::string(dir) + "/" + e->d_name).c_str());
+    }
+    closedir(d);
+    rmdir(dir);
+}
+
+TEST(TestCache)
+{
+    char dir[] = "/tmp/TestFilterModelTablesXXXXXX";
+    CHECK(mkdtemp(dir) != nullptr);
+    TableCache::setDirectory(dir);
+
+    Model solved;
+    CHECK(!solved.tables.build(nullptr, 0));
+
+    // Mapped from the file written by the first model
+    Model cached;
+    CHECK(cached.tables.build(nullptr, 0));
+    CHECK(cached.summer != solved.summer);
+    CHECK_ARRAY_EQUAL(solved.summer, cached.summer, SIZE);
+    CHECK_ARRAY_EQUAL(solved.gain, cached.gain, SIZE);
+
+    TableCache::setDirectory(nullptr);
+
+    removeDirectory(dir);
+}
+
+TEST(TestCorruptCache)
+{
+    char dir[] = "/tmp/TestFilterModelTablesXXXXXX";
+    CHECK(mkdtemp(dir) != nullptr);
+    TableCache::setDirectory(dir);
+
+    Model solved;
+    CHECK(!solved.tables.build(nullptr, 0));
+
+    // The tables are now mapped from the file
+    const std::vector<unsigned short> summer(solved.summer, solved.summer + SIZE);
+    const std::vector<unsigned short> gain(solved.gain, solved.gain + SIZE);
+
+    // Damage the last entry of the cached tables
+    DIR *d = opendir(dir);
+    for (dirent *e = readdir(d); e != nullptr; e = readdir(d))
+    {
+        if (e->d_name[0] == '.')
+            continue;
+
+        FILE *f = fopen((std::string(dir) + "/" + e->d_name).c_str(), "r+b");
+        CHECK(f != nullptr);
+        fseek(f, -1, SEEK_END);
+        const int c = fgetc(f);
+        fseek(f, -1, SEEK_END);
+        fputc(c ^ 0x01, f);
+        fclose(f);
+    }
+    closedir(d);
+
+    // Solved again rather than mapped
+    Model rebuilt;
+    CHECK(!rebuilt.tables.build(nullptr, 0));
+    CHECK_ARRAY_EQUAL(&summer[0], rebuilt.summer, SIZE);
+    CHECK_ARRAY_EQUAL(&gain[0], rebuilt.gain, SIZE);
+
+    TableCache::setDirectory(nullptr);
+
+    removeDirectory(dir);
+}
+
+TEST(TestCacheReplaced)
+{
+    char dir[] = "/tmp/TestFilterModelTablesXXXXXX";
+    CHECK(mkdtemp(dir) != nullptr);
+    TableCache::setDirectory(dir);
+
+    Model solved;
+    solved.tables.build(nullptr, 0);
+    const std::vector<unsigned short> summer(solved.summer, solved.summer + SIZE);
+
+    // Another table for the same key replaces the file
+    header_t header;
+    DIR *d = opendir(dir);
+    for (dirent *e = readdir(d); e != nullptr; e = readdir(d))
+    {
+        if (e->d_name[0] == '.')
+            continue;
+
+        FILE *f = fopen((std::string(dir) + "/" + e->d_name).c_str(), "rb");
+        CHECK(f != nullptr);
+        CHECK_EQUAL(1u, fread(&header, sizeof(header), 1, f));
+        fclose(f);
+    }
+    closedir(d);
+
+    const size_t size = header.size;
+    const std::vector<unsigned short> zero(size / sizeof(unsigned short), 0);
+    const void *replaced = TableCache::store("filter", header.key, &zero[0], size);
+    CHECK(replaced != nullptr);
+
+    Model mapped;
+    CHECK(mapped.tables.build(nullptr, 0));
+    CHECK_EQUAL(0, mapped.summer[SIZE - 1]);
+
+    // The tables mapped before are untouched
+    CHECK_ARRAY_EQUAL(&summer[0], solved.summer, SIZE);
+
+    TableCache::release(replaced, size);
+    TableCache::setDirectory(nullptr);
+
+    removeDirectory(dir);
+}
+
+}
@@ -0,0 +1,194 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include "../src/builders/residfp-builder/residfp/version.cc"
+#include "../src/builders/residfp-builder/residfp/TableCache.cpp"
+#include "../src/builders/residfp-builder/residfp/resample/FirCache.h"
+#include "../src/builders/residfp-builder/residfp/resample/FirCache.cpp"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace UnitTest;
+using namespace reSIDfp;
+
+/*
+ * Fills a table with its row index and counts the builds.
+ */
+class CountingBuilder : public FirCache::Builder
+{
+public:
+    mutable std::atomic<int> builds;
+
+    CountingBuilder() : builds(0) {}
+
+    void build(short *table) const override
+    {
+        builds++;
+        for (int i = 0; i < 4; i++)
+            table[i] = i;
+    }
+};
+
+/*
+ * Builds nothing, for tables sized to fill the cache.
+ */
+class NullBuilder : public FirCache::Builder
+{
+public:
+    void build(short *) const override {}
+};
+
+FirCache::params_t params(double cyclesPerSample, int firRES = 2, int firN = 2)
+{
+    FirCache::params_t p;
+    p.firN = firN;
+    p.firRES = firRES;
+    p.cyclesPerSample = cyclesPerSample;
+    p.precision = 16;
+    return p;
+}
+
+/// A table using about a third of the cache memory.
+const int BIG_RES = FirCache::MAX_MEMORY / 3 / 1024 / sizeof(short);
+
+SUITE(FirCache)
+{
+
+TEST(TestShared)
+{
+    CountingBuilder builder;
+
+    FirCache::Entry *a = FirCache::acquire(params(1.), builder);
+    FirCache::Entry *b = FirCache::acquire(params(1.), builder);
+
+    CHECK(a == b);
+    CHECK_EQUAL(1, builder.builds.load());
+    CHECK_EQUAL(3, FirCache::table(a)[3]);
+
+    FirCache::release(a);
+    FirCache::release(b);
+
+    // Still cached when not in use
+    FirCache::Entry *c = FirCache::acquire(params(1.), builder);
+    CHECK_EQUAL(1, builder.builds.load());
+    FirCache::release(c);
+}
+
+TEST(TestDistinct)
+{
+    CountingBuilder builder;
+
+    FirCache::Entry *a = FirCache::acquire(params(2.), builder);
+    FirCache::Entry *b = FirCache::acquire(params(2.5), builder);
+    FirCache::Entry *c = FirCache::acquire(params(2., 4, 1), builder);
+
+    CHECK(a != b);
+    CHECK(a != c);
+    CHECK_EQUAL(3, builder.builds.load());
+
+    FirCache::release(a);
+    FirCache::release(b);
+    FirCache::release(c);
+}
+
+TEST(TestEviction)
+{
+    NullBuilder builder;
+
+    for (int i = 0; i < 8; i++)
+    {
+        FirCache::Entry *entry = FirCache::acquire(params(3. + i, BIG_RES, 1024), builder);
+        FirCache::release(entry);
+        CHECK(FirCache::memoryUsed() <= FirCache::MAX_MEMORY);
+    }
+
+    // The least recently used tables are gone
+    CountingBuilder counting;
+    FirCache::Entry *entry = FirCache::acquire(params(3., BIG_RES, 1024), counting);
+    CHECK_EQUAL(1, counting.builds.load());
+    FirCache::release(entry);
+}
+
+TEST(TestInUse)
+{
+    NullBuilder builder;
+    std::vector<FirCache::Entry*> entries;
+
+    // Tables in use are never evicted, the excess ones are private
+    for (int i = 0; i < 4; i++)
+    {
+        entries.push_back(FirCache::acquire(params(20. + i, BIG_RES, 1024), builder));
+        CHECK(FirCache::memoryUsed() <= FirCache::MAX_MEMORY);
+    }
+
+    CountingBuilder counting;
+    for (int i = 0; i < 4; i++)
+    {
+        FirCache::Entry *entry = FirCache::acquire(params(20. + i, BIG_RES, 1024), counting);
+        CHECK(FirCache::table(entry) != nullptr);
+        FirCache::release(entry);
+    }
+    CHECK_EQUAL(1, counting.builds.load());
+
+    for (int i = 0; i < 4; i++)
+        FirCache::release(entries[i]);
+}
+
+/*
+ * Acquires a table from another thread.
+ */
+class Acquirer
+{
+public:
+    const CountingBuilder &builder;
+    FirCache::Entry *entry;
+
+    Acquirer(const CountingBuilder &builder) : builder(builder), entry(nullptr) {}
+
+    void operator()() { entry = FirCache::acquire(params(30.), builder); }
+};
+
+TEST(TestThreads)
+{
+    CountingBuilder builder;
+    std::vector<Acquirer> acquirers(8, Acquirer(builder));
+    std::vector<std::thread> threads;
+
+    for (unsigned int i = 0; i < acquirers.size(); i++)
+        threads.push_back(std::thread(std::ref(acquirers[i])));
+
+    for (unsigned int i = 0; i < threads.size(); i++)
+        threads[i].join();
+
+    CHECK_EQUAL(1, builder.builds.load());
+
+    for (unsigned int i = 0; i < acquirers.size(); i++)
+    {
+        CHECK(acquirers[i].entry == acquirers[0].entry);
+        FirCache::release(acquirers[i].entry);
+    }
+}
+
+}
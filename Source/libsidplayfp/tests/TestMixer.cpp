@@ -0,0 +1,204 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright (C) 2020 Leandro Nini
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include <cstdlib>
+#include <vector>
+
+#define private public
+#define protected public
+
+#include "../src/mixer.cpp"
+#include "../src/sidemu.cpp"
+
+using namespace UnitTest;
+using namespace libsidplayfp;
+
+/*
+ * A chip that makes a ramp of samples, as many as told for each clock.
+ */
+class RampSid : public sidemu
+{
+public:
+    bool direct;
+    int pending;
+    short next;
+    int direct_samples;
+
+public:
+    RampSid(bool supported, short first) :
+        sidemu(nullptr),
+        direct(supported),
+        pending(0),
+        next(first),
+        direct_samples(0)
+    {
+        m_buffer = new short[OUTPUTBUFFERSIZE];
+    }
+
+    ~RampSid() { delete[] m_buffer; }
+
+    uint8_t read(uint_least8_t) override { return 0; }
+    void write(uint_least8_t, uint8_t) override {}
+    void reset(uint8_t) override {}
+    void voice(unsigned int, bool) override {}
+    void model(SidConfig::sid_model_t, bool) override {}
+
+    bool directOutput() const override { return direct; }
+
+    void clock() override
+    {
+        for (; pending > 0; pending--)
+        {
+            if (m_outputPos < m_outputSize)
+            {
+                m_output[m_outputPos++ * m_outputStride] = next++;
+                direct_samples++;
+            }
+            else
+                m_buffer[m_bufferpos++] = next++;
+        }
+    }
+};
+
+/*
+ * Fill the buffer as the player does, with the chips making
+ * the given number of samples between two mixes.
+ */
+void play(Mixer &mixer, std::vector<short> &buffer, int samples)
+{
+    mixer.begin(&buffer[0], buffer.size());
+    while (mixer.notFinished())
+    {
+        for (unsigned int k = 0; k < Mixer::MAX_SIDS; k++)
+        {
+            RampSid *chip = static_cast<RampSid*>(mixer.getSid(k));
+            if (chip != nullptr)
+                chip->pending = samples;
+        }
+
+        mixer.clockChips();
+        mixer.doMix();
+    }
+}
+
+SUITE(Mixer)
+{
+
+/*
+ * Play a ramp on two stereo chips into buffers that are not a multiple
+ * of the rendered blocks, so that some samples are left over for the next one.
+ */
+std::vector<short> playStereo(bool direct, int &directSamples)
+{
+    RampSid left(direct, 0);
+    RampSid right(direct, 10000);
+
+    Mixer mixer;
+    mixer.setStereo(true);
+    mixer.setVolume(Mixer::VOLUME_MAX, Mixer::VOLUME_MAX);
+    mixer.addSid(&left);
+    mixer.addSid(&right);
+    CHECK_EQUAL(direct, mixer.m_passthrough);
+
+    srand(1);
+
+    std::vector<short> output;
+    const int sizes[] = { 200, 64, 2, 1000, 38 };
+    for (int n = 0; n < 5; n++)
+    {
+        std::vector<short> buffer(sizes[n], -1);
+        play(mixer, buffer, 30);
+        output.insert(output.end(), buffer.begin(), buffer.end());
+    }
+
+    CHECK_EQUAL(left.direct_samples, right.direct_samples);
+    directSamples = left.direct_samples;
+    return output;
+}
+
+TEST(TestDirectOutput)
+{
+    int directSamples;
+    const std::vector<short> mixed = playStereo(false, directSamples);
+    CHECK_EQUAL(0, directSamples);
+
+    const std::vector<short> direct = playStereo(true, directSamples);
+    CHECK(directSamples > 0);
+
+    // Same samples and dithering as the mixing path
+    CHECK_EQUAL(mixed.size(), direct.size());
+    CHECK_ARRAY_EQUAL(&mixed[0], &direct[0], mixed.size());
+
+    int dithered = 0;
+    for (size_t i = 0; i < direct.size(); i += 2)
+    {
+        const short expected = i / 2;
+        CHECK(std::abs(direct[i] - expected) <= 1);
+        CHECK(std::abs(direct[i + 1] - (10000 + expected)) <= 1);
+        if (direct[i] != expected)
+            dithered++;
+    }
+    CHECK(dithered > 0);
+}
+
+TEST(TestPassthrough)
+{
+    RampSid first(true, 0);
+    RampSid second(true, 0);
+    RampSid other(false, 0);
+
+    Mixer mixer;
+    mixer.setStereo(false);
+    mixer.setVolume(Mixer::VOLUME_MAX, Mixer::VOLUME_MAX);
+    mixer.addSid(&first);
+    CHECK(mixer.m_passthrough);
+
+    // Two chips on one channel are mixed
+    mixer.addSid(&second);
+    CHECK(!mixer.m_passthrough);
+
+    mixer.setStereo(true);
+    CHECK(mixer.m_passthrough);
+
+    // Scaled
+    mixer.setVolume(Mixer::VOLUME_MAX, Mixer::VOLUME_MAX / 2);
+    CHECK(!mixer.m_passthrough);
+    mixer.setVolume(Mixer::VOLUME_MAX, Mixer::VOLUME_MAX);
+
+    // Filtered
+    mixer.setFastForward(2);
+    CHECK(!mixer.m_passthrough);
+    mixer.setFastForward(1);
+
+    // Chip that can't render into the output
+    mixer.clearSids();
+    mixer.addSid(&first);
+    mixer.addSid(&other);
+    CHECK(!mixer.m_passthrough);
+
+    std::vector<short> buffer(100);
+    play(mixer, buffer, 30);
+    CHECK_EQUAL(0, first.direct_samples);
+}
+
+}
@@ -30,6 +30,7 @@
 #include "../src/c64/CPU/mos6510.h"
 #include "../src/c64/CPU/opcodes.h"
 #include "../src/c64/CPU/mos6510.cpp"
+#include "../src/c64/CPU/mos6510profile.cpp"
 
 #include <iostream>
 #include <iomanip>
@@ -60,6 +61,8 @@ public:
 
     void setMem(uint8_t offset, uint8_t opcode) { mem[0x1000+offset] = opcode; }
 
+    void poke(uint_least16_t addr, uint8_t data) { mem[addr] = data; }
+
     void print() {
         std::cout << "-> " << std::hex << (int)getInstr() << std::endl;
     }
@@ -67,6 +70,37 @@ public:
     bool check(uint8_t opcode) const { return getInstr() == opcode; }
 };
 
+class irqTrigger final : public Event
+{
+private:
+    testcpu &m_cpu;
+
+public:
+    irqTrigger(testcpu &cpu) :
+        Event("IRQ trigger"),
+        m_cpu(cpu) {}
+
+    void event() override { m_cpu.triggerIRQ(); }
+};
+
+/*
+ * Run the cpu until the interrupt, triggered at the given cycle, is taken.
+ */
+event_clock_t runUntilIrq(EventScheduler &scheduler, testcpu &cpu, unsigned int irqCycle, unsigned int &events)
+{
+    irqTrigger trigger(cpu);
+    scheduler.schedule(trigger, irqCycle, EVENT_CLOCK_PHI1);
+
+    events = 0;
+    do
+    {
+        scheduler.clock();
+        events++;
+    } while (!cpu.check(BRKn));
+
+    return scheduler.getTime(EVENT_CLOCK_PHI2);
+}
+
 SUITE(mos6510)
 {
 
@@ -374,4 +408,83 @@ TEST_FIXTURE(TestFixture, TestPlp2Rdy)
     CHECK(cpu.check(BRKn));
 }
 
+/*
+ * Idle loops are skipped up to the next event but
+ * the interrupt is taken at the same cycle as when
+ * running the loop in the I/O area, which is never skipped.
+ */
+TEST(TestIdleLoop)
+{
+    EventScheduler scheduler1;
+    testcpu cpu1(scheduler1);
+    scheduler1.reset();
+    cpu1.reset();
+
+    // CLI; JMP *
+    cpu1.setMem(0, CLIn);
+    cpu1.setMem(1, JMPw);
+    cpu1.setMem(2, 0x01);
+    cpu1.setMem(3, 0x10);
+
+    unsigned int events1;
+    const event_clock_t time1 = runUntilIrq(scheduler1, cpu1, 1000, events1);
+
+    EventScheduler scheduler2;
+    testcpu cpu2(scheduler2);
+    scheduler2.reset();
+    cpu2.reset();
+
+    // JMP $D000; CLI; JMP *
+    cpu2.setMem(0, JMPw);
+    cpu2.setMem(1, 0x00);
+    cpu2.setMem(2, 0xd0);
+    cpu2.poke(0xd000, CLIn);
+    cpu2.poke(0xd001, JMPw);
+    cpu2.poke(0xd002, 0x01);
+    cpu2.poke(0xd003, 0xd0);
+
+    unsigned int events2;
+    const event_clock_t time2 = runUntilIrq(scheduler2, cpu2, 1003, events2);
+
+    CHECK_EQUAL(time2, time1 + 3);
+    CHECK(events1 < events2);
+}
+
+TEST_FIXTURE(TestFixture, TestProfile)
+{
+    cpu.profile(true);
+
+    // CLI; NOP; JMP $1001
+    cpu.setMem(0, CLIn);
+    cpu.setMem(1, NOPn);
+    cpu.setMem(2, JMPw);
+    cpu.setMem(3, 0x01);
+    cpu.setMem(4, 0x10);
+
+    // IRQ handler: NOP; RTI
+    cpu.poke(0xfffe, 0x00);
+    cpu.poke(0xffff, 0x20);
+    cpu.poke(0x2000, NOPn);
+    cpu.poke(0x2001, RTIn);
+
+    unsigned int events;
+    runUntilIrq(scheduler, cpu, 100, events);
+    cpu.clearIRQ();
+
+    for (int i = 0; i < 100; i++)
+        scheduler.clock();
+
+    const MOS6510Profile *profile = cpu.getProfile();
+
+    CHECK_EQUAL(1, profile->getInterruptCount(MOS6510Profile::IRQ));
+    CHECK_EQUAL(1, profile->getOpcodeCount(MOS6510Profile::INTERRUPT));
+    CHECK_EQUAL(7, profile->getOpcodeCycles(MOS6510Profile::INTERRUPT));
+    CHECK_EQUAL(1, profile->getOpcodeCount(RTIn));
+    CHECK_EQUAL(6, profile->getOpcodeCycles(RTIn));
+    CHECK_EQUAL(1, profile->getHandlerCount());
+    CHECK_EQUAL(15, profile->getHandlerMin());
+    CHECK_EQUAL(15, profile->getHandlerMax());
+    CHECK_EQUAL(2, profile->getAddressCycles(0x2000));
+}
+
 }
@@ -0,0 +1,607 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include <cstring>
+#include <vector>
+
+#include "../src/EventScheduler.h"
+#include "../src/EventScheduler.cpp"
+
+#define private public
+#define protected public
+
+#include "../src/c64/CIA/mos652x.h"
+#include "../src/c64/CIA/mos652x.cpp"
+#include "../src/c64/CIA/timer.cpp"
+#include "../src/c64/CIA/tod.cpp"
+#include "../src/c64/CIA/interrupt.cpp"
+#include "../src/c64/CIA/SerialPort.cpp"
+
+using namespace UnitTest;
+using namespace libsidplayfp;
+
+/// PAL clock divided by the 50 Hz power frequency.
+const unsigned int PAL_RATE = 985248 / 50;
+
+/// A second at the PAL clock.
+const event_clock_t SECOND = 985248;
+
+/*
+ * The TOD as it was before the ticks were counted on demand,
+ * clocked by an event at each 50/60 Hz tick.
+ */
+class reftod final : public Event
+{
+private:
+    EventScheduler &eventScheduler;
+
+    MOS652X &parent;
+
+    const uint8_t &cra;
+    const uint8_t &crb;
+
+    event_clock_t cycles;
+    event_clock_t period;
+
+    unsigned int todtickcounter;
+
+    bool isLatched;
+    bool isStopped;
+
+    uint8_t clock[4];
+    uint8_t latch[4];
+    uint8_t alarm[4];
+
+private:
+    void checkAlarm()
+    {
+        if (!memcmp(alarm, clock, sizeof(alarm)))
+        {
+            parent.todInterrupt();
+        }
+    }
+
+    void event() override
+    {
+        cycles += period;
+
+        // Fixed precision 25.7
+        eventScheduler.schedule(*this, cycles >> 7);
+        cycles &= 0x7F; // Just keep the decimal part
+
+        if (!isStopped)
+        {
+            // count 50/60 hz ticks
+            todtickcounter++;
+            todtickcounter &= 7;
+            // if the counter matches the TOD frequency ...
+            if (todtickcounter == ((cra & 0x80) ? 5 : 6))
+            {
+                // reset the counter and update the timer
+                todtickcounter = 0;
+                Tod::advanceCounters(clock);
+                checkAlarm();
+            }
+        }
+    }
+
+public:
+    reftod(EventScheduler &scheduler, MOS652X &parent, uint8_t regs[0x10]) :
+        Event("Reference TOD"),
+        eventScheduler(scheduler),
+        parent(parent),
+        cra(regs[0x0e]),
+        crb(regs[0x0f]),
+        cycles(0),
+        period(0),
+        todtickcounter(0),
+        isLatched(false),
+        isStopped(true) {}
+
+    void reset()
+    {
+        cycles = 0;
+        todtickcounter = 0;
+
+        memset(clock, 0, sizeof(clock));
+        clock[Tod::HOURS] = 1;
+        memcpy(latch, clock, sizeof(latch));
+        memset(alarm, 0, sizeof(alarm));
+
+        isLatched = false;
+        isStopped = true;
+
+        eventScheduler.schedule(*this, 0, EVENT_CLOCK_PHI1);
+    }
+
+    uint8_t read(uint_least8_t reg)
+    {
+        if (!isLatched)
+            memcpy(latch, clock, sizeof(latch));
+
+        if (reg == Tod::TENTHS)
+            isLatched = false;
+        else if (reg == Tod::HOURS)
+            isLatched = true;
+
+        return latch[reg];
+    }
+
+    void write(uint_least8_t reg, uint8_t data)
+    {
+        switch (reg)
+        {
+        case Tod::TENTHS:
+            data &= 0x0f;
+            break;
+        case Tod::SECONDS:
+        case Tod::MINUTES:
+            data &= 0x7f;
+            break;
+        case Tod::HOURS:
+            data &= 0x9f;
+            if ((data & 0x1f) == 0x12 && !(crb & 0x80))
+                data ^= 0x80;
+            break;
+        }
+
+        bool changed = false;
+        if (crb & 0x80)
+        {
+            if (alarm[reg] != data)
+            {
+                changed = true;
+                alarm[reg] = data;
+            }
+        }
+        else
+        {
+            if (reg == Tod::TENTHS)
+            {
+                if (isStopped)
+                {
+                    todtickcounter = 0;
+                    isStopped = false;
+                }
+            }
+            else if (reg == Tod::HOURS)
+            {
+                isStopped = true;
+            }
+
+            if (clock[reg] != data)
+            {
+                changed = true;
+                clock[reg] = data;
+            }
+        }
+
+        if (changed)
+        {
+            checkAlarm();
+        }
+    }
+
+    void setPeriod(event_clock_t clock) { period = clock * (1 << 7); }
+};
+
+/*
+ * A CIA that logs when its IRQ line changes.
+ */
+class testcia final : public MOS652X
+{
+private:
+    EventScheduler &m_scheduler;
+    bool m_irq;
+    const bool m_stepping;
+    reftod m_tod;
+
+public:
+    /// time << 1 | state
+    std::vector<event_clock_t> changes;
+
+protected:
+    void interrupt(bool state) override
+    {
+        if (state != m_irq)
+        {
+            m_irq = state;
+            changes.push_back((m_scheduler.getTime(EVENT_CLOCK_PHI1) << 1) | (state ? 1 : 0));
+        }
+    }
+
+public:
+    /*
+     * When stepping the timers are clocked through every read
+     * and the TOD is replaced by the one ticking on events,
+     * as before the CIA could count them on demand.
+     */
+    testcia(EventScheduler &scheduler, bool stepping) :
+        MOS652X(scheduler),
+        m_scheduler(scheduler),
+        m_irq(false),
+        m_stepping(stepping),
+        m_tod(scheduler, *this, regs) {}
+
+    void reset() override
+    {
+        MOS652X::reset();
+        if (m_stepping)
+            m_tod.reset();
+        m_irq = false;
+        changes.clear();
+    }
+
+    void setRate(unsigned int clock)
+    {
+        setDayOfTimeRate(clock);
+        m_tod.setPeriod(clock);
+    }
+
+    uint8_t peek(uint_least8_t addr)
+    {
+        if (!m_stepping)
+            return read(addr);
+
+        timerA.syncWithCpu();
+        timerA.wakeUpAfterSyncWithCpu();
+        timerB.syncWithCpu();
+        timerB.wakeUpAfterSyncWithCpu();
+
+        if ((addr >= TOD_TEN) && (addr <= TOD_HR))
+            return m_tod.read(addr - TOD_TEN);
+
+        return read(addr);
+    }
+
+    void poke(uint_least8_t addr, uint8_t data)
+    {
+        if (m_stepping && (addr >= TOD_TEN) && (addr <= TOD_HR))
+        {
+            // The TOD here stays stopped and never schedules the alarm
+            timerA.syncWithCpu();
+            timerB.syncWithCpu();
+            m_tod.write(addr - TOD_TEN, data);
+            timerA.wakeUpAfterSyncWithCpu();
+            timerB.wakeUpAfterSyncWithCpu();
+            return;
+        }
+
+        write(addr, data);
+    }
+};
+
+/*
+ * Stop the event loop at a given cycle, in the CPU phase.
+ */
+class marker final : public Event
+{
+public:
+    bool fired;
+
+    marker() :
+        Event("Marker"),
+        fired(false) {}
+
+    void event() override { fired = true; }
+};
+
+/*
+ * Two CIAs, one skipping and one stepping,
+ * fed the same accesses at the same cycles.
+ */
+class TestFixture
+{
+public:
+    EventScheduler scheduler;
+    testcia skipping;
+    testcia stepping;
+    marker stop;
+    uint32_t seed;
+
+public:
+    TestFixture() :
+        skipping(scheduler, false),
+        stepping(scheduler, true),
+        seed(1)
+    {
+        scheduler.reset();
+        skipping.setRate(PAL_RATE);
+        stepping.setRate(PAL_RATE);
+        skipping.reset();
+        stepping.reset();
+
+        // Access in the CPU phase
+        run(1);
+    }
+
+    unsigned int random(unsigned int range)
+    {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 8) % range;
+    }
+
+    /*
+     * Run until the CPU phase of the given cycle.
+     */
+    void runTo(event_clock_t time)
+    {
+        stop.fired = false;
+        scheduler.schedule(stop, time - scheduler.getTime(EVENT_CLOCK_PHI2), EVENT_CLOCK_PHI2);
+        while (!stop.fired)
+            scheduler.clock();
+    }
+
+    void run(event_clock_t cycles)
+    {
+        runTo(scheduler.getTime(EVENT_CLOCK_PHI2) + cycles);
+    }
+
+    void poke(uint_least8_t addr, uint8_t data)
+    {
+        skipping.poke(addr, data);
+        stepping.poke(addr, data);
+    }
+
+    /*
+     * Read a register from both and compare.
+     */
+    uint8_t peek(uint_least8_t addr)
+    {
+        const uint8_t expected = stepping.peek(addr);
+        const uint8_t value = skipping.peek(addr);
+        CHECK_EQUAL(static_cast<int>(expected), static_cast<int>(value));
+        return value;
+    }
+
+    void checkInterrupts()
+    {
+        CHECK_EQUAL(stepping.changes.size(), skipping.changes.size());
+        if (stepping.changes.size() == skipping.changes.size() && !stepping.changes.empty())
+            CHECK_ARRAY_EQUAL(&stepping.changes[0], &skipping.changes[0], stepping.changes.size());
+    }
+
+    /*
+     * Set the clock or, with CRB bit 7 set, the alarm.
+     */
+    void setTod(uint8_t hours, uint8_t minutes, uint8_t seconds, uint8_t tenths)
+    {
+        poke(TOD_HR, hours);
+        poke(TOD_MIN, minutes);
+        poke(TOD_SEC, seconds);
+        poke(TOD_TEN, tenths);
+    }
+
+    void readTod()
+    {
+        peek(TOD_HR);
+        peek(TOD_MIN);
+        peek(TOD_SEC);
+        peek(TOD_TEN);
+    }
+};
+
+SUITE(Mos652x)
+{
+
+/*
+ * The clock keeps the same time over many frames,
+ * through the hour and AM/PM changes,
+ * read at random cycles and latched by the hours.
+ */
+TEST_FIXTURE(TestFixture, TestTodClock)
+{
+    setTod(0x11, 0x59, 0x57, 0x00);
+
+    for (unsigned int i = 0; i < 1000; i++)
+    {
+        run(1 + random(SECOND / 50));
+
+        switch (random(4))
+        {
+        case 0:
+            readTod();
+            break;
+        case 1:
+            // Latched while the clock goes on
+            peek(TOD_HR);
+            run(random(SECOND / 5));
+            peek(TOD_SEC);
+            peek(TOD_TEN);
+            break;
+        case 2:
+            peek(TOD_TEN + random(4));
+            break;
+        default:
+            // The clock counts the ticks by five or by six
+            poke(CRA, random(2) << 7);
+            break;
+        }
+    }
+
+    readTod();
+
+    // After more than 10 seconds the hour has changed
+    CHECK_EQUAL(0x92, static_cast<int>(peek(TOD_HR)));
+    peek(TOD_TEN);
+}
+
+/*
+ * The alarm interrupt fires on the same cycle,
+ * with the clock running at either rate.
+ */
+TEST_FIXTURE(TestFixture, TestTodAlarm)
+{
+    poke(ICR, 0x84);
+
+    setTod(0x01, 0x00, 0x00, 0x00);
+
+    poke(CRB, 0x80);
+    setTod(0x01, 0x00, 0x01, 0x05);
+    poke(CRB, 0x00);
+
+    run(2 * SECOND);
+    CHECK_EQUAL(1U, skipping.changes.size());
+    peek(IDR);
+
+    // At 50 Hz the ticks are counted by five instead of six
+    poke(CRA, 0x80);
+    poke(CRB, 0x80);
+    setTod(0x01, 0x00, 0x03, 0x02);
+    poke(CRB, 0x00);
+
+    run(2 * SECOND);
+    CHECK_EQUAL(3U, skipping.changes.size());
+    peek(IDR);
+
+    checkInterrupts();
+}
+
+/*
+ * An alarm in the past only fires when the clock
+ * comes round to it, one set to the current time
+ * fires at once.
+ */
+TEST_FIXTURE(TestFixture, TestTodAlarmInThePast)
+{
+    poke(ICR, 0x84);
+
+    setTod(0x01, 0x00, 0x10, 0x00);
+    run(SECOND / 3);
+
+    poke(CRB, 0x80);
+    setTod(0x01, 0x00, 0x05, 0x00);
+    poke(CRB, 0x00);
+
+    // Longer than the alarm look ahead
+    run(80 * SECOND);
+    CHECK(skipping.changes.empty());
+
+    // Now the clock comes round to the alarm
+    setTod(0x01, 0x00, 0x04, 0x08);
+    run(SECOND / 2);
+    CHECK_EQUAL(1U, skipping.changes.size());
+    peek(IDR);
+
+    // Set to the current time, not on the cycle of the acknowledge
+    run(1);
+    readTod();
+    poke(CRB, 0x80);
+    setTod(skipping.tod.clock[Tod::HOURS], skipping.tod.clock[Tod::MINUTES],
+        skipping.tod.clock[Tod::SECONDS], skipping.tod.clock[Tod::TENTHS]);
+    poke(CRB, 0x00);
+    run(10);
+    CHECK_EQUAL(3U, skipping.changes.size());
+    peek(IDR);
+
+    checkInterrupts();
+}
+
+/*
+ * The 50/60 Hz setting is changed while the alarm
+ * is pending, the ticks counted so far keep their rate.
+ */
+TEST_FIXTURE(TestFixture, TestTodAlarmRateChange)
+{
+    poke(ICR, 0x84);
+
+    for (unsigned int i = 0; i < 20; i++)
+    {
+        setTod(0x01, 0x00, 0x00, 0x00);
+
+        poke(CRB, 0x80);
+        setTod(0x01, 0x00, 0x02, 0x00);
+        poke(CRB, 0x00);
+
+        // Change anywhere within a tenth of second
+        run(SECOND / 2 + random(SECOND / 10));
+        poke(CRA, 0x80);
+        run(random(SECOND / 10));
+        poke(CRA, 0x00);
+
+        run(2 * SECOND);
+        peek(IDR);
+    }
+
+    CHECK_EQUAL(40U, skipping.changes.size());
+    checkInterrupts();
+}
+
+/*
+ * Timer reads while counting down and around underflows,
+ * where the skipping timer has to agree cycle by cycle.
+ */
+TEST_FIXTURE(TestFixture, TestTimerReads)
+{
+    poke(ICR, 0x83);
+
+    for (unsigned int i = 0; i < 300; i++)
+    {
+        switch (random(5))
+        {
+        case 0:
+        {
+            // Continuous or one shot, maybe forcing a load
+            const bool a = random(2);
+            poke(a ? TAL : TBL, random(256));
+            poke(a ? TAH : TBH, random(4));
+            poke(a ? CRA : CRB, 0x01 | (random(2) << 3) | (random(2) << 4) | (random(2) << 1));
+            break;
+        }
+        case 1:
+            // Timer B counting timer A underflows
+            poke(CRB, 0x41 | (random(2) << 4));
+            break;
+        case 2:
+            poke(random(2) ? CRA : CRB, 0x00);
+            break;
+        case 3:
+        {
+            // Every cycle across an underflow
+            const unsigned int cycles = 200 + random(1200);
+            for (unsigned int c = 0; c < cycles; c++)
+            {
+                run(1);
+                peek(TAL + random(4));
+            }
+            break;
+        }
+        default:
+            break;
+        }
+
+        run(1 + random(3000));
+        peek(TAL);
+        peek(TAH);
+        peek(TBL);
+        peek(TBH);
+        peek(CRA);
+        peek(CRB);
+        peek(IDR);
+    }
+
+    CHECK(skipping.changes.size() > 100);
+    checkInterrupts();
+}
+
+}
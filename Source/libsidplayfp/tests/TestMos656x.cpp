@@ -0,0 +1,273 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include "../src/EventScheduler.h"
+#include "../src/EventScheduler.cpp"
+
+#define private protected
+
+#include "../src/c64/VIC_II/mos656x.h"
+#include "../src/c64/VIC_II/mos656x.cpp"
+
+#include <vector>
+
+using namespace UnitTest;
+using namespace libsidplayfp;
+
+/*
+ * A VIC that logs when its IRQ and BA lines change.
+ */
+class testvic final : public MOS656X
+{
+private:
+    EventScheduler &m_scheduler;
+    bool m_irq;
+    bool m_ba;
+    const bool m_idleSkip;
+
+public:
+    /// time << 2 | line << 1 | state
+    std::vector<event_clock_t> changes;
+
+private:
+    void record(int line, bool state)
+    {
+        changes.push_back((m_scheduler.getTime(EVENT_CLOCK_PHI1) << 2) | (line << 1) | (state ? 1 : 0));
+    }
+
+protected:
+    void interrupt(bool state) override
+    {
+        if (state != m_irq)
+        {
+            m_irq = state;
+            record(1, state);
+        }
+    }
+
+    void setBA(bool state) override
+    {
+        if (state != m_ba)
+        {
+            m_ba = state;
+            record(0, state);
+        }
+    }
+
+public:
+    testvic(EventScheduler &scheduler, bool idleSkip) :
+        MOS656X(scheduler),
+        m_scheduler(scheduler),
+        m_irq(false),
+        m_ba(true),
+        m_idleSkip(idleSkip) {}
+
+    /*
+     * Without idle skip the raster is clocked line by line,
+     * as it was before the VIC could sleep.
+     */
+    void event() override
+    {
+        if (m_idleSkip)
+        {
+            MOS656X::event();
+            return;
+        }
+
+        const event_clock_t cycles = eventScheduler.getTime(eventScheduler.phase()) - rasterClk;
+
+        event_clock_t delay;
+
+        if (cycles)
+        {
+            // Update x raster
+            rasterClk += cycles;
+            lineCycle += cycles;
+            lineCycle %= cyclesPerLine;
+
+            delay = (this->*clock)();
+        }
+        else
+            delay = 1;
+
+        eventScheduler.schedule(*this, delay - eventScheduler.phase(), EVENT_CLOCK_PHI1);
+    }
+
+    uint8_t peek(uint_least8_t addr) { return read(addr); }
+
+    void poke(uint_least8_t addr, uint8_t data) { write(addr, data); }
+
+    bool isIdling() const { return idling; }
+
+    /*
+     * Drop the changes from the given time on,
+     * the other VIC may not have got there yet.
+     */
+    void truncate(event_clock_t time)
+    {
+        while (!changes.empty() && (changes.back() >> 2) >= time)
+            changes.pop_back();
+    }
+};
+
+/*
+ * Write the same random data to both VICs at random cycles,
+ * as the CPU would, favouring the registers that decide when
+ * the raster IRQ fires and when the bus is stolen.
+ */
+class writer final : public Event
+{
+private:
+    EventScheduler &m_scheduler;
+    testvic &m_sleeping;
+    testvic &m_stepping;
+    uint32_t m_seed;
+
+public:
+    unsigned int writes;
+    unsigned int idleWrites;
+
+private:
+    unsigned int random(unsigned int range)
+    {
+        m_seed = m_seed * 1103515245 + 12345;
+        return (m_seed >> 8) % range;
+    }
+
+    void poke(uint_least8_t addr, uint8_t data)
+    {
+        if (m_sleeping.isIdling())
+            idleWrites++;
+        writes++;
+
+        m_sleeping.poke(addr, data);
+        m_stepping.poke(addr, data);
+    }
+
+public:
+    writer(EventScheduler &scheduler, testvic &sleeping, testvic &stepping) :
+        Event("Writer"),
+        m_scheduler(scheduler),
+        m_sleeping(sleeping),
+        m_stepping(stepping),
+        m_seed(1),
+        writes(0),
+        idleWrites(0) {}
+
+    void event() override
+    {
+        // Reading has no side effects
+        const unsigned int line = m_stepping.peek(0x12) | ((m_stepping.peek(0x11) & 0x80) << 1);
+
+        switch (random(8))
+        {
+        case 0:
+        case 1:
+            // Raster compare on the current or one of the next lines
+        {
+            const unsigned int irqLine = line + random(3);
+            poke(0x11, (random(256) & 0x7f) | ((irqLine >> 1) & 0x80));
+            poke(0x12, irqLine & 0xff);
+            break;
+        }
+        case 2:
+            // Display on/off and vertical scroll
+            poke(0x11, random(256));
+            break;
+        case 3:
+            poke(0x12, random(256));
+            break;
+        case 4:
+            // Acknowledge and mask
+            poke(0x19, 0x0f);
+            poke(0x1a, random(2));
+            break;
+        case 5:
+            // Sprites starting on a near line
+            poke(0x01 + (random(8) << 1), (line + random(4)) & 0xff);
+            break;
+        case 6:
+            poke(0x15, random(4) ? 0 : random(256));
+            break;
+        default:
+            poke(0x17, random(256));
+            break;
+        }
+
+        m_scheduler.schedule(*this, 1 + random(4000), EVENT_CLOCK_PHI2);
+    }
+};
+
+SUITE(Mos656x)
+{
+
+/*
+ * Raster IRQ and BA happen on the same cycles whether
+ * the VIC sleeps through idle lines or is clocked line by line.
+ */
+void checkIdleSkip(MOS656X::model_t model)
+{
+    EventScheduler scheduler;
+    testvic sleeping(scheduler, true);
+    testvic stepping(scheduler, false);
+    writer cpu(scheduler, sleeping, stepping);
+
+    scheduler.reset();
+    sleeping.chip(model);
+    stepping.chip(model);
+    scheduler.schedule(cpu, 1, EVENT_CLOCK_PHI2);
+
+    const event_clock_t end = 4000000;
+    while (scheduler.getTime(EVENT_CLOCK_PHI1) < end)
+        scheduler.clock();
+
+    sleeping.truncate(end);
+    stepping.truncate(end);
+
+    CHECK(cpu.idleWrites > cpu.writes / 4);
+    CHECK(stepping.changes.size() > 1000);
+
+    CHECK_EQUAL(stepping.changes.size(), sleeping.changes.size());
+    CHECK_ARRAY_EQUAL(&stepping.changes[0], &sleeping.changes[0], stepping.changes.size());
+
+    CHECK_EQUAL(stepping.peek(0x11), sleeping.peek(0x11));
+    CHECK_EQUAL(stepping.peek(0x12), sleeping.peek(0x12));
+    CHECK_EQUAL(stepping.peek(0x19), sleeping.peek(0x19));
+}
+
+TEST(TestIdleSkipPAL)
+{
+    checkIdleSkip(MOS656X::MOS6569);
+}
+
+TEST(TestIdleSkipNTSC)
+{
+    checkIdleSkip(MOS656X::MOS6567R8);
+}
+
+TEST(TestIdleSkipOldNTSC)
+{
+    checkIdleSkip(MOS656X::MOS6567R56A);
+}
+
+}
@@ -25,6 +25,7 @@
 #include "../src/sidplayfp/SidTuneInfo.h"
 
 #include <stdint.h>
+#include <cstdio>
 #include <cstring>
 
 #define BUFFERSIZE 128
@@ -97,6 +98,73 @@ TEST_FIXTURE(TestFixture, TestLoadOk)
     CHECK_EQUAL("No errors", tune.statusString());
 }
 
+/*
+ * A tune loaded from file is the same as one loaded from memory.
+ */
+TEST_FIXTURE(TestFixture, TestLoadFromFile)
+{
+    const char fileName[] = "TestPSID.sid";
+    FILE *f = fopen(fileName, "wb");
+    CHECK(f != nullptr);
+    fwrite(data, 1, BUFFERSIZE, f);
+    fclose(f);
+
+    SidTune tune(fileName);
+    SidTune reference(data, BUFFERSIZE);
+    remove(fileName);
+
+    CHECK(tune.getStatus());
+    CHECK_EQUAL(reference.getInfo()->c64dataLen(), tune.getInfo()->c64dataLen());
+    CHECK_EQUAL(reference.getInfo()->dataFileLen(), tune.getInfo()->dataFileLen());
+    CHECK_ARRAY_EQUAL(reference.c64Data(), tune.c64Data(), tune.getInfo()->c64dataLen());
+    CHECK_EQUAL(reference.createMD5(), tune.createMD5());
+    CHECK_EQUAL(reference.createMD5New(), tune.createMD5New());
+}
+
+/*
+ * A loaded tune does not depend on its file any more.
+ */
+TEST_FIXTURE(TestFixture, TestFileTruncatedAfterLoad)
+{
+    const char fileName[] = "TestPSID.sid";
+    FILE *f = fopen(fileName, "wb");
+    CHECK(f != nullptr);
+    fwrite(data, 1, BUFFERSIZE, f);
+    fclose(f);
+
+    SidTune tune(fileName);
+
+    // Truncate the file
+    f = fopen(fileName, "wb");
+    CHECK(f != nullptr);
+    fclose(f);
+    remove(fileName);
+
+    SidTune reference(data, BUFFERSIZE);
+
+    CHECK(tune.getStatus());
+    CHECK_ARRAY_EQUAL(reference.c64Data(), tune.c64Data(), tune.getInfo()->c64dataLen());
+    CHECK_EQUAL(reference.createMD5New(), tune.createMD5New());
+}
+
+/*
+ * A truncated file is rejected.
+ */
+TEST_FIXTURE(TestFixture, TestLoadTruncatedFile)
+{
+    const char fileName[] = "TestPSID.sid";
+    FILE *f = fopen(fileName, "wb");
+    CHECK(f != nullptr);
+    fwrite(data, 1, 100, f);
+    fclose(f);
+
+    SidTune tune(fileName);
+    remove(fileName);
+
+    CHECK(!tune.getStatus());
+    CHECK_EQUAL("SIDTUNE ERROR: File is most likely truncated", tune.statusString());
+}
+
 /*
  * Version must be at least 2 for RSID files.
  */
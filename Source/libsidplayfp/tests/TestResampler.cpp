@@ -0,0 +1,251 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include "../src/builders/residfp-builder/residfp/version.cc"
+#include "../src/builders/residfp-builder/residfp/TableCache.cpp"
+#include "../src/builders/residfp-builder/residfp/resample/FirCache.cpp"
+#include "../src/builders/residfp-builder/residfp/resample/convolve.cpp"
+#include "../src/builders/residfp-builder/residfp/resample/SincResampler.cpp"
+#include "../src/builders/residfp-builder/residfp/resample/ResamplerPlanner.cpp"
+#include "../src/builders/residfp-builder/residfp/resample/TwoPassSincResampler.h"
+#include "../src/builders/residfp-builder/residfp/resample/ZeroOrderResampler.h"
+
+#include <memory>
+#include <vector>
+
+using namespace UnitTest;
+using namespace reSIDfp;
+
+const double CLOCK = 985248.;
+
+/// Enough cycles for a few hundred samples.
+const unsigned int CYCLES = 20000;
+
+std::vector<int> noise()
+{
+    std::vector<int> samples(CYCLES);
+    unsigned int seed = 1;
+    for (unsigned int i = 0; i < CYCLES; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        // Beyond the 16 bit range, to exercise the clipping
+        samples[i] = static_cast<int>(seed >> 14) - 131072;
+    }
+    return samples;
+}
+
+/*
+ * Check that inputBlock gives the same samples as input()
+ * for any block size.
+ */
+void checkBlocks(Resampler &single, Resampler &block, unsigned int blockSize)
+{
+    const std::vector<int> samples = noise();
+
+    single.reset();
+    block.reset();
+
+    std::vector<int> expected;
+    for (unsigned int i = 0; i < CYCLES; i++)
+    {
+        if (single.input(samples[i]))
+            expected.push_back(single.getOutput());
+    }
+
+    std::vector<int> actual;
+    std::vector<int> buf(blockSize);
+    for (unsigned int i = 0; i < CYCLES; i += blockSize)
+    {
+        const unsigned int count = std::min(blockSize, CYCLES - i);
+        std::copy(samples.begin() + i, samples.begin() + i + count, buf.begin());
+
+        // In place
+        const unsigned int n = block.inputBlock(&buf[0], count, &buf[0]);
+        for (unsigned int j = 0; j < n; j++)
+            actual.push_back(block.softClip(buf[j]));
+    }
+
+    CHECK(expected.size() > 100);
+    CHECK_EQUAL(expected.size(), actual.size());
+    CHECK_ARRAY_EQUAL(&expected[0], &actual[0], std::min(expected.size(), actual.size()));
+}
+
+/// Taps only, the cost model of the original two pass design.
+const ResamplerPlanner::cost_model_t TAP_COST = { 0., 1e-9 };
+
+/// A host where calls are as expensive as 64 taps.
+const ResamplerPlanner::cost_model_t CALL_COST = { 64e-9, 1e-9 };
+
+SUITE(Resampler)
+{
+
+TEST(TestSinc)
+{
+    const unsigned int sizes[] = { 1, 7, 22, 23, 256, 1000 };
+    for (unsigned int i = 0; i < 6; i++)
+    {
+        SincResampler single(CLOCK, 44100., 20000.);
+        SincResampler block(CLOCK, 44100., 20000.);
+        checkBlocks(single, block, sizes[i]);
+    }
+}
+
+TEST(TestTwoPass)
+{
+    const unsigned int sizes[] = { 1, 13, 256 };
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        std::unique_ptr<TwoPassSincResampler> single(TwoPassSincResampler::create(CLOCK, 48000., 20000.));
+        std::unique_ptr<TwoPassSincResampler> block(TwoPassSincResampler::create(CLOCK, 48000., 20000.));
+        checkBlocks(*single, *block, sizes[i]);
+    }
+}
+
+TEST(TestZeroOrder)
+{
+    const unsigned int sizes[] = { 1, 13, 256 };
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        ZeroOrderResampler single(CLOCK, 44100.);
+        ZeroOrderResampler block(CLOCK, 44100.);
+        checkBlocks(single, block, sizes[i]);
+    }
+}
+
+TEST(TestHighResolution)
+{
+    TwoPassSincResampler single(CLOCK, 48000., 20000., 120000., SincResampler::DEFAULT_PRECISION, true);
+    TwoPassSincResampler block(CLOCK, 48000., 20000., 120000., SincResampler::DEFAULT_PRECISION, true);
+    checkBlocks(single, block, 13);
+
+    // Below the clipping threshold both modes give the same output
+    const std::vector<int> samples = noise();
+    SincResampler clipped(CLOCK, 44100., 20000.);
+    SincResampler unclipped(CLOCK, 44100., 20000., SincResampler::DEFAULT_PRECISION, true);
+    clipped.reset();
+    unclipped.reset();
+
+    unsigned int outputs = 0;
+    int peak = 0;
+    for (unsigned int i = 0; i < CYCLES; i++)
+    {
+        const bool ready = clipped.input(samples[i] / 8);
+        CHECK_EQUAL(ready, unclipped.input(samples[i] / 8));
+        if (ready)
+        {
+            CHECK_EQUAL(clipped.output(), unclipped.output());
+            outputs++;
+        }
+    }
+    CHECK(outputs > 100);
+
+    // Beyond it the unclipped output keeps the full range
+    for (unsigned int i = 0; i < CYCLES; i++)
+    {
+        if (unclipped.input(samples[i]))
+            peak = std::max(peak, std::abs(unclipped.output()));
+    }
+    CHECK(peak > 32768);
+}
+
+TEST(TestPlanKeepsGanier)
+{
+    // At the usual rates Ganier's intermediate rate is near optimal
+    const ResamplerPlanner::plan_t plan = ResamplerPlanner::plan(CLOCK, 44100., 19845., 16, TAP_COST);
+    const double ganier = 2. * 19845. + sqrt(2. * 19845. * CLOCK * (44100. - 2. * 19845.) / 44100.);
+    CHECK_EQUAL(ganier, plan.intermediateFrequency);
+}
+
+TEST(TestPlanSinglePassAtHighRates)
+{
+    const ResamplerPlanner::plan_t plan192 = ResamplerPlanner::plan(CLOCK, 192000., 20000., 16, CALL_COST);
+    CHECK_EQUAL(0., plan192.intermediateFrequency);
+
+    const ResamplerPlanner::plan_t plan96 = ResamplerPlanner::plan(CLOCK, 96000., 20000., 16, CALL_COST);
+    CHECK_EQUAL(0., plan96.intermediateFrequency);
+
+    // Ganier's rate is kept at the usual rates
+    const ResamplerPlanner::plan_t plan48 = ResamplerPlanner::plan(CLOCK, 48000., 20000., 16, CALL_COST);
+    CHECK(plan48.intermediateFrequency > 48000.);
+}
+
+TEST(TestPlanDefaultCost)
+{
+    // The settings used by reSIDfp always give the same resampler
+    const double ganier441 = 2. * 19845. + sqrt(2. * 19845. * CLOCK * (44100. - 2. * 19845.) / 44100.);
+    const ResamplerPlanner::plan_t plan441 = ResamplerPlanner::plan(CLOCK, 44100., 19845., 16, ResamplerPlanner::DEFAULT_COST);
+    CHECK_EQUAL(ganier441, plan441.intermediateFrequency);
+
+    const double ganier48 = 2. * 20000. + sqrt(2. * 20000. * CLOCK * (48000. - 2. * 20000.) / 48000.);
+    const ResamplerPlanner::plan_t plan48 = ResamplerPlanner::plan(CLOCK, 48000., 20000., 16, ResamplerPlanner::DEFAULT_COST);
+    CHECK_EQUAL(ganier48, plan48.intermediateFrequency);
+
+    const ResamplerPlanner::plan_t plan96 = ResamplerPlanner::plan(CLOCK, 96000., 20000., 16, ResamplerPlanner::DEFAULT_COST);
+    CHECK_EQUAL(0., plan96.intermediateFrequency);
+
+    const ResamplerPlanner::plan_t plan192 = ResamplerPlanner::plan(CLOCK, 192000., 20000., 16, ResamplerPlanner::DEFAULT_COST);
+    CHECK_EQUAL(0., plan192.intermediateFrequency);
+}
+
+TEST(TestPlanFitsRingBuffer)
+{
+    // A single pass filter would not fit
+    CHECK(SincResampler::filterLength(CLOCK, 22050., 9922., 16) > SincResampler::MAX_FILTER_LENGTH);
+
+    const ResamplerPlanner::plan_t plan = ResamplerPlanner::plan(CLOCK, 22050., 9922., 16, CALL_COST);
+    CHECK(plan.intermediateFrequency > 22050.);
+    CHECK(SincResampler::filterLength(CLOCK, plan.intermediateFrequency, 9922., 16) <= SincResampler::MAX_FILTER_LENGTH);
+    CHECK(SincResampler::filterLength(plan.intermediateFrequency, 22050., 9922., 16) <= SincResampler::MAX_FILTER_LENGTH);
+}
+
+TEST(TestPlanLowPrecision)
+{
+    const ResamplerPlanner::plan_t high = ResamplerPlanner::plan(CLOCK, 48000., 20000., 16, TAP_COST);
+    const ResamplerPlanner::plan_t low = ResamplerPlanner::plan(CLOCK, 48000., 16000., 10, TAP_COST);
+    CHECK(low.cost < high.cost);
+
+    // 60 dB need less than two thirds of the taps of 96 dB
+    CHECK(3 * SincResampler::filterLength(CLOCK, 48000., 20000., 10) < 2 * SincResampler::filterLength(CLOCK, 48000., 20000., 16));
+}
+
+TEST(TestPlannedResampler)
+{
+    const double rates[] = { 44100., 96000., 192000. };
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        std::unique_ptr<Resampler> resampler(ResamplerPlanner::create(CLOCK, rates[i], 20000., 16));
+        resampler->reset();
+
+        unsigned int outputs = 0;
+        for (unsigned int j = 0; j < CYCLES; j++)
+        {
+            if (resampler->input(0))
+                outputs++;
+        }
+
+        const double expected = CYCLES * rates[i] / CLOCK;
+        CHECK_CLOSE(expected, outputs, 2.);
+    }
+}
+
+}
@@ -0,0 +1,243 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ * Copyright (C) 2020 Leandro Nini
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+#define private public
+#define protected public
+
+#include "../src/builders/resid-builder/resid/sid.h"
+#include "../src/builders/residfp-builder/residfp/TableImage.h"
+
+using namespace UnitTest;
+using namespace reSID;
+
+const double CLOCK = 985248.;
+
+/*
+ * Three voices and the filter busy.
+ */
+void play(SID &sid)
+{
+    static const reg8 regs[][2] =
+    {
+        { 0x00, 0x34 }, { 0x01, 0x12 }, { 0x03, 0x08 }, { 0x05, 0x00 }, { 0x06, 0xf0 }, { 0x04, 0x21 },
+        { 0x07, 0x78 }, { 0x08, 0x23 }, { 0x0a, 0x08 }, { 0x0c, 0x00 }, { 0x0d, 0xf0 }, { 0x0b, 0x41 },
+        { 0x0e, 0x00 }, { 0x0f, 0x31 }, { 0x13, 0x00 }, { 0x14, 0xf0 }, { 0x12, 0x81 },
+        { 0x15, 0x03 }, { 0x16, 0x40 }, { 0x17, 0xf7 }, { 0x18, 0x1f },
+    };
+
+    for (unsigned int i = 0; i < sizeof(regs) / sizeof(regs[0]); i++)
+        sid.write(regs[i][0], regs[i][1]);
+}
+
+short clip(int input)
+{
+    return input > 32767 ? 32767 : input < -32768 ? -32768 : input;
+}
+
+/*
+ * The output sample of the resampling methods with the original
+ * scalar convolution, from the state the sample was calculated with.
+ */
+short reference(SID &sid)
+{
+    if (sid.sampling == SAMPLE_RESAMPLE_FASTMEM)
+    {
+        const int fir_offset = sid.sample_offset*sid.fir_RES >> SID::FIXP_SHIFT;
+        const short* fir_start = sid.fir + fir_offset*sid.fir_N;
+        const short* sample_start = sid.sample + sid.sample_index - sid.fir_N + SID::RINGSIZE;
+
+        int v = 0;
+        for (int j = 0; j < sid.fir_N; j++)
+            v += sample_start[j]*fir_start[j];
+
+        return clip(v >> SID::FIR_SHIFT);
+    }
+
+    int fir_offset = sid.sample_offset*sid.fir_RES >> SID::FIXP_SHIFT;
+    const int fir_offset_rmd = sid.sample_offset*sid.fir_RES & SID::FIXP_MASK;
+    const short* fir_start = sid.fir + fir_offset*sid.fir_N;
+    const short* sample_start = sid.sample + sid.sample_index - sid.fir_N - 1 + SID::RINGSIZE;
+
+    int v1 = 0;
+    for (int j = 0; j < sid.fir_N; j++)
+        v1 += sample_start[j]*fir_start[j];
+
+    if (++fir_offset == sid.fir_RES)
+    {
+        fir_offset = 0;
+        ++sample_start;
+    }
+    fir_start = sid.fir + fir_offset*sid.fir_N;
+
+    int v2 = 0;
+    for (int k = 0; k < sid.fir_N; k++)
+        v2 += sample_start[k]*fir_start[k];
+
+    const int v = v1 + int((unsigned(fir_offset_rmd)*unsigned(v2 - v1)) >> SID::FIXP_SHIFT);
+
+    return clip(v >> SID::FIR_SHIFT);
+}
+
+void checkResample(chip_model model, sampling_method method, double rate)
+{
+    SID sid;
+    sid.set_chip_model(model);
+    CHECK(sid.set_sampling_parameters(CLOCK, method, rate));
+    sid.reset();
+    play(sid);
+
+    for (int i = 0; i < 3000; i++)
+    {
+        // One sample at a time, so that the state is the one it was made from
+        cycle_count delta_t = 1000;
+        short output;
+        CHECK_EQUAL(1, sid.clock(delta_t, &output, 1));
+        CHECK_EQUAL(reference(sid), output);
+    }
+}
+
+SUITE(Resid)
+{
+
+TEST(TestResample)
+{
+    const double rates[] = { 44100., 48000., 96000. };
+    for (int r = 0; r < 3; r++)
+    {
+        checkResample(MOS6581, SAMPLE_RESAMPLE, rates[r]);
+        checkResample(MOS8580, SAMPLE_RESAMPLE, rates[r]);
+    }
+}
+
+TEST(TestResampleFastmem)
+{
+    checkResample(MOS6581, SAMPLE_RESAMPLE_FASTMEM, 44100.);
+    checkResample(MOS8580, SAMPLE_RESAMPLE_FASTMEM, 48000.);
+}
+
+TEST(TestFilterBias)
+{
+    // A filter built over leftover data behaves as a fresh one
+    SID first;
+
+    void* memory = operator new(sizeof(SID));
+    memset(memory, 0xa5, sizeof(SID));
+    SID* second = new (memory) SID;
+
+    CHECK_EQUAL(first.filter.Vw_bias, second->filter.Vw_bias);
+    CHECK_EQUAL(first.filter.nVgt, second->filter.nVgt);
+
+    first.reset();
+    second->reset();
+    play(first);
+    play(*second);
+
+    short a[1000];
+    short b[1000];
+    cycle_count t1 = 20000;
+    cycle_count t2 = 20000;
+    const int n = first.clock(t1, a, 1000);
+    CHECK_EQUAL(n, second->clock(t2, b, 1000));
+    CHECK_ARRAY_EQUAL(a, b, n);
+
+    second->~SID();
+    operator delete(memory);
+}
+
+TEST(TestDefaultModel)
+{
+    // Without a model selected the tables of the default one are built
+    // on first use
+    SID implicit;
+    SID selected;
+    selected.set_chip_model(MOS6581);
+
+    play(implicit);
+    play(selected);
+
+    short a[1000];
+    short b[1000];
+    cycle_count t1 = 20000;
+    cycle_count t2 = 20000;
+    const int n = implicit.clock(t1, a, 1000);
+    CHECK(Filter::model_init[MOS6581]);
+    CHECK_EQUAL(n, selected.clock(t2, b, 1000));
+    CHECK_ARRAY_EQUAL(a, b, n);
+}
+
+TEST(TestTableImage)
+{
+    SID sid;
+    sid.set_chip_model(MOS8580);
+
+    std::vector<unsigned char> image;
+    Filter::encode_tables(MOS8580, image);
+
+    unsigned short* data[4];
+    unsigned int size[4];
+    const int n = Filter::opamp_tables(MOS8580, data, size);
+    CHECK_EQUAL(4, n);
+
+    std::vector<reSIDfp::TableImage::table_t> tables;
+    std::vector<std::vector<unsigned short> > solved(n);
+    for (int t = 0; t < n; t++)
+    {
+        solved[t].assign(data[t], data[t] + size[t]);
+        memset(data[t], 0, size[t] * sizeof(unsigned short));
+        reSIDfp::TableImage::table_t table = { data[t], size[t] };
+        tables.push_back(table);
+    }
+
+    Filter::opamp_t* opamp6581 = new Filter::opamp_t[1 << 16];
+    Filter::opamp_table(MOS6581, opamp6581);
+    Filter::opamp_t* opamp = new Filter::opamp_t[1 << 16];
+    Filter::opamp_table(MOS8580, opamp);
+
+    // The image is bound to the model parameters
+    CHECK(!reSIDfp::TableImage::decode(tables, Filter::tables_fingerprint(MOS6581, opamp6581), &image[0], image.size()));
+
+    // and to the op-amp table, down to the last entry
+    opamp[(1 << 16) - 1].vx++;
+    CHECK(!reSIDfp::TableImage::decode(tables, Filter::tables_fingerprint(MOS8580, opamp), &image[0], image.size()));
+    opamp[(1 << 16) - 1].vx--;
+
+    CHECK(reSIDfp::TableImage::decode(tables, Filter::tables_fingerprint(MOS8580, opamp), &image[0], image.size()));
+    for (int t = 0; t < n; t++)
+    {
+        CHECK_ARRAY_EQUAL(&solved[t][0], data[t], size[t]);
+    }
+
+    // The first entries are checked against the solver
+    CHECK(Filter::solve_tables(MOS8580, opamp, 64, true));
+    data[1][10]++;
+    CHECK(!Filter::solve_tables(MOS8580, opamp, 64, true));
+    data[1][10]--;
+    delete[] opamp;
+    delete[] opamp6581;
+}
+
+}
@@ -0,0 +1,343 @@
+/*
+ * This file is part of libsidplayfp, a SID player engine.
+ *
+ *  Copyright (C) 2020 Leandro Nini
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include "UnitTest++/UnitTest++.h"
+#include "UnitTest++/TestReporter.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#define private public
+#define protected public
+
+#include "../src/builders/residfp-builder/residfp/SID.h"
+#include "../src/builders/residfp-builder/residfp/Filter.h"
+
+using namespace UnitTest;
+using namespace reSIDfp;
+
+const double CLOCK = 985248.;
+
+/// Long enough for the external filter to settle between the edges.
+const unsigned int SLOW_PERIOD = 100000;
+
+/// Just below the Nyquist frequency at 48 kHz.
+const unsigned int FAST_PERIOD = 42;
+
+const unsigned int CYCLES = 4 * SLOW_PERIOD;
+
+/// Cycles clocked at once.
+const unsigned int CHUNK = 5000;
+
+/// Irregular chunk sizes up to CHUNK, to put register accesses anywhere in an output block.
+const unsigned int CHUNKS[] = { 1, 2, 3, 255, 256, 257, 511, 700, 1000, 3001 };
+const unsigned int NUM_CHUNKS = sizeof(CHUNKS) / sizeof(CHUNKS[0]);
+
+/*
+ * A filter whose output is a square wave,
+ * to drive the external filter and the resampler to full scale.
+ */
+class SquareFilter final : public Filter
+{
+private:
+    const unsigned short low;
+    const unsigned short high;
+    const unsigned int period;
+    unsigned int count;
+
+protected:
+    void updatedCenterFrequency() override {}
+    void updateResonance(unsigned char) override {}
+    void updatedMixing() override {}
+
+public:
+    SquareFilter(unsigned short low, unsigned short high, unsigned int period) :
+        low(low),
+        high(high),
+        period(period),
+        count(0) {}
+
+    void getState(state_t &state) const override
+    {
+        memset(&state, 0, sizeof(state));
+        state.Vhp = count;
+    }
+
+    unsigned short clock(int, int, int) override
+    {
+        return ((count++ % period) < period / 2) ? high : low;
+    }
+
+    void clock(const int*, const int*, const int*, unsigned short* out, unsigned int cycles) override
+    {
+        for (unsigned int i = 0; i < cycles; i++)
+            out[i] = clock(0, 0, 0);
+    }
+
+    void input(int) override {}
+};
+
+/*
+ * Get the unclipped output of a chip whose filter
+ * outputs a square wave between the given values.
+ */
+std::vector<int> render(double rate, unsigned short low, unsigned short high, unsigned int period)
+{
+    SID sid;
+    sid.setSamplingParameters(CLOCK, RESAMPLE, rate, 20000., 16, true);
+    sid.reset();
+
+    SquareFilter square(low, high, period);
+    sid.filter = &square;
+
+    std::vector<int> output;
+    std::vector<int> buf(CHUNK);
+    for (unsigned int c = 0; c < CYCLES; c += CHUNK)
+    {
+        const int n = sid.clock(CHUNK, &buf[0]);
+        output.insert(output.end(), buf.begin(), buf.begin() + n);
+    }
+
+    return output;
+}
+
+/*
+ * Two chips fed the same accesses, one clocked in chunks
+ * and a reference clocked a cycle at a time.
+ * Single cycles never skip the voices or the filters,
+ * so the outputs must match sample by sample.
+ */
+class Comparison
+{
+private:
+    SID sid;
+    SID reference;
+
+    unsigned int chunk;
+
+public:
+    Comparison(ChipModel model) :
+        chunk(0)
+    {
+        sid.setChipModel(model);
+        sid.setSamplingParameters(CLOCK, RESAMPLE, 48000., 20000., 16, true);
+        sid.reset();
+
+        reference.setChipModel(model);
+        reference.setSamplingParameters(CLOCK, RESAMPLE, 48000., 20000., 16, true);
+        reference.reset();
+    }
+
+    void write(int offset, unsigned char value)
+    {
+        sid.write(offset, value);
+        reference.write(offset, value);
+    }
+
+    /*
+     * Clock both chips in irregular chunks, reading OSC3
+     * and ENV3 between them, and compare everything.
+     */
+    void clock(unsigned int cycles)
+    {
+        std::vector<int> buf(CHUNK);
+        std::vector<int> expected;
+        expected.reserve(CHUNK);
+
+        while (cycles != 0)
+        {
+            const unsigned int n = std::min(cycles, CHUNKS[chunk++ % NUM_CHUNKS]);
+            cycles -= n;
+
+            const int samples = sid.clock(n, &buf[0]);
+
+            expected.clear();
+            for (unsigned int i = 0; i < n; i++)
+            {
+                int sample;
+                if (reference.clock(1, &sample) != 0)
+                    expected.push_back(sample);
+            }
+
+            CHECK_EQUAL(expected.size(), static_cast<size_t>(samples));
+            if (expected.size() != static_cast<size_t>(samples))
+                return;
+            CHECK_ARRAY_EQUAL(&expected[0], &buf[0], samples);
+
+            CHECK_EQUAL(static_cast<int>(reference.read(0x1b)), static_cast<int>(sid.read(0x1b)));
+            CHECK_EQUAL(static_cast<int>(reference.read(0x1c)), static_cast<int>(sid.read(0x1c)));
+        }
+    }
+
+    /*
+     * Check that the chip has settled, so the following
+     * cycles would be filled in without clocking.
+     */
+    bool settled()
+    {
+        int buf[SID::OUTPUT_BLOCK];
+        return sid.clockSettled(buf, SID::OUTPUT_BLOCK) == SID::OUTPUT_BLOCK;
+    }
+};
+
+SUITE(SID)
+{
+
+/*
+ * The unclipped output is linear up to the largest swing of the
+ * external filter: a full scale square wave must give twice
+ * the output of a half scale one.
+ */
+void checkFullScale(double rate, unsigned int period, int expectedPeak)
+{
+    const std::vector<int> full = render(rate, 0, 65535, period);
+    const std::vector<int> half = render(rate, 16384, 49151, period);
+
+    CHECK(full.size() > 1000);
+    CHECK_EQUAL(full.size(), half.size());
+
+    int peak = 0;
+    int worst = 0;
+    for (unsigned int i = 0; i < full.size(); i++)
+    {
+        peak = std::max(peak, std::abs(full[i]));
+        worst = std::max(worst, std::abs(full[i] - 2 * half[i]));
+    }
+
+    CHECK(peak > expectedPeak);
+    CHECK(worst < 64);
+}
+
+TEST(TestFullScaleDC)
+{
+    // Each edge steps between settled levels
+    checkFullScale(48000., SLOW_PERIOD, 40000);
+    checkFullScale(96000., SLOW_PERIOD, 40000);
+}
+
+TEST(TestFullScaleAlternating)
+{
+    checkFullScale(48000., FAST_PERIOD, 20000);
+    checkFullScale(96000., FAST_PERIOD, 20000);
+}
+
+/*
+ * A note is played and released to silence, where the chip
+ * settles, then a register write wakes it up again.
+ */
+void checkSettled(ChipModel model)
+{
+    Comparison c(model);
+
+    c.write(0x18, 0x1f); // low pass, full volume
+    c.write(0x17, 0xf1); // voice 1 filtered, full resonance
+    c.write(0x16, 0x40);
+
+    c.write(0x00, 0x00);
+    c.write(0x01, 0x10);
+    c.write(0x05, 0x00); // fast attack and decay
+    c.write(0x06, 0xf0); // full sustain, fast release
+    c.write(0x04, 0x21); // sawtooth, gate
+
+    c.clock(50000);
+
+    // The external filter takes the longest to settle
+    c.write(0x04, 0x20); // release
+    c.clock(1000000);
+
+    // Filter outputs off, the filter state changes
+    // without reaching the output
+    c.write(0x18, 0x0f);
+    c.clock(1000000);
+    c.write(0x16, 0x80);
+    c.write(0x17, 0x01);
+    c.clock(20000);
+
+    c.write(0x18, 0x1e); // low pass, volume change
+    c.clock(1000000);
+
+    CHECK(c.settled());
+}
+
+TEST(TestSettled6581)
+{
+    checkSettled(MOS6581);
+}
+
+TEST(TestSettled8580)
+{
+    checkSettled(MOS8580);
+}
+
+/*
+ * Silent voices are advanced at once, unless a playing voice
+ * is ring modulated by them, and voice 3 is read through OSC3
+ * while it is silent.
+ */
+void checkSilentVoices(ChipModel model)
+{
+    Comparison c(model);
+
+    c.write(0x18, 0x0f);
+
+    // Voice 1, playing, ring modulated by the silent voice 3
+    c.write(0x00, 0x00);
+    c.write(0x01, 0x08);
+    c.write(0x05, 0x00);
+    c.write(0x06, 0xf0);
+    c.write(0x04, 0x15); // triangle, ring modulation, gate
+
+    // Voice 2, silent
+    c.write(0x07, 0x45);
+    c.write(0x08, 0x23);
+    c.write(0x0b, 0x40); // pulse
+
+    // Voice 3, silent
+    c.write(0x0e, 0x67);
+    c.write(0x0f, 0x05);
+    c.write(0x12, 0x20); // sawtooth
+
+    c.clock(100000);
+
+    // Nothing plays, but OSC3 keeps running
+    c.write(0x04, 0x14);
+    c.clock(100000);
+
+    c.write(0x12, 0x10); // triangle
+    c.clock(100000);
+
+    c.write(0x12, 0x80); // noise
+    c.clock(100000);
+}
+
+TEST(TestSilentVoices6581)
+{
+    checkSilentVoices(MOS6581);
+}
+
+TEST(TestSilentVoices8580)
+{
+    checkSilentVoices(MOS8580);
+}
+
+}
@@ -21,6 +21,8 @@
 #include "UnitTest++/UnitTest++.h"
 #include "UnitTest++/TestReporter.h"
 
+#include "../src/builders/residfp-builder/residfp/version.cc"
+#include "../src/builders/residfp-builder/residfp/TableCache.cpp"
 #include "../src/builders/residfp-builder/residfp/WaveformCalculator.cpp"
 #include "../src/builders/residfp-builder/residfp/Dac.cpp"
 
@@ -162,4 +164,83 @@ TEST(TestNoiseWriteBack1)
     CHECK_EQUAL(0xf0, (int)generator.readOSC());
 }
 
+
+TEST(TestAdvance)
+{
+    matrix_t* tables = reSIDfp::WaveformCalculator::getInstance()->buildTable(reSIDfp::MOS8580);
+
+    const unsigned int freqs[] = { 0, 1, 0x1234, 0x8000, 0xffff };
+    const unsigned char controls[] = { 0x80, 0x40, 0x20, 0x10 };
+
+    reSIDfp::WaveformGenerator modulator;
+
+    for (unsigned int f = 0; f < 5; f++)
+    {
+        for (unsigned int c = 0; c < 4; c++)
+        {
+            reSIDfp::WaveformGenerator expected;
+            reSIDfp::WaveformGenerator actual;
+
+            reSIDfp::WaveformGenerator* generators[] = { &expected, &actual };
+            for (unsigned int g = 0; g < 2; g++)
+            {
+                generators[g]->setChipModel(reSIDfp::MOS8580);
+                generators[g]->setWaveformModels(tables);
+                generators[g]->reset();
+                // Land exactly on bit 19 after a few cycles
+                generators[g]->accumulator = 0x80000 - 16 * freqs[f];
+                generators[g]->writeFREQ_LO(freqs[f] & 0xff);
+                generators[g]->writeFREQ_HI(freqs[f] >> 8);
+                generators[g]->writePW_HI(0x08);
+                generators[g]->writeCONTROL_REG(controls[c]);
+            }
+
+            CHECK(actual.canAdvance());
+
+            // Over several bit 19 edges for the higher frequencies
+            for (unsigned int n = 3; n < 600; n += 37)
+            {
+                for (unsigned int i = 0; i < n; i++)
+                {
+                    expected.clock();
+                    expected.output(&modulator);
+                }
+
+                actual.advance(n - 2);
+                for (unsigned int i = 0; i < 2; i++)
+                {
+                    actual.clock();
+                    actual.output(&modulator);
+                }
+
+                CHECK_EQUAL(expected.accumulator, actual.accumulator);
+                CHECK_EQUAL(expected.msb_rising, actual.msb_rising);
+                CHECK_EQUAL(expected.shift_register, actual.shift_register);
+                CHECK_EQUAL(expected.shift_pipeline, actual.shift_pipeline);
+                CHECK_EQUAL(expected.waveform_output, actual.waveform_output);
+                CHECK_EQUAL(expected.pulse_output, actual.pulse_output);
+                CHECK_EQUAL((int)expected.readOSC(), (int)actual.readOSC());
+            }
+        }
+    }
+}
+
+TEST(TestCanAdvance)
+{
+    matrix_t* tables = reSIDfp::WaveformCalculator::getInstance()->buildTable(reSIDfp::MOS6581);
+
+    reSIDfp::WaveformGenerator generator;
+    generator.setWaveformModels(tables);
+    generator.reset();
+
+    generator.writeCONTROL_REG(0x08); // test bit
+    CHECK(!generator.canAdvance());
+
+    generator.writeCONTROL_REG(0x90); // noise + triangle writes back
+    CHECK(!generator.canAdvance());
+
+    generator.writeCONTROL_REG(0x60); // sawtooth masks the accumulator on 6581
+    CHECK(!generator.canAdvance());
+}
+
 }